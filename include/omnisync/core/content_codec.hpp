@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include "../network/vle_encoding.hpp"
+
+namespace omnisync {
+namespace core {
+
+/**
+ * @brief How element values are written by VLEPacker and Sequence::save().
+ *
+ * - One-byte integral types (char) are a single raw byte.
+ * - Wider integral types (char32_t code points, ids, handles) are LEB128
+ *   of their unsigned value, so ASCII and most code points take 1-3 bytes.
+ * - Other trivially copyable types (small structs) are copied byte for byte.
+ *
+ * Specialize for anything else. Every encoding must take at least one byte.
+ */
+template <typename T, typename Enable = void>
+struct ContentCodec {
+    static_assert(std::is_trivially_copyable_v<T>, "Specialize ContentCodec for this element type");
+
+    static void encode(const T& value, std::vector<uint8_t>& out) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    static bool decode(const std::vector<uint8_t>& in, size_t& offset, T& value) {
+        if (offset > in.size() || in.size() - offset < sizeof(T)) return false;
+        std::memcpy(&value, in.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    static size_t encodedSize(const T&) {
+        return sizeof(T);
+    }
+};
+
+template <typename T>
+struct ContentCodec<T, std::enable_if_t<std::is_integral_v<T> && sizeof(T) == 1>> {
+    static void encode(const T& value, std::vector<uint8_t>& out) {
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    static bool decode(const std::vector<uint8_t>& in, size_t& offset, T& value) {
+        if (offset >= in.size()) return false;
+        value = static_cast<T>(in[offset++]);
+        return true;
+    }
+
+    static size_t encodedSize(const T&) {
+        return 1;
+    }
+};
+
+template <typename T>
+struct ContentCodec<T, std::enable_if_t<std::is_integral_v<T> && (sizeof(T) > 1)>> {
+    using Unsigned = std::make_unsigned_t<T>;
+
+    static void encode(const T& value, std::vector<uint8_t>& out) {
+        network::VLEEncoding::encodeUInt64(static_cast<Unsigned>(value), out);
+    }
+
+    static bool decode(const std::vector<uint8_t>& in, size_t& offset, T& value) {
+        uint64_t raw;
+        if (!network::VLEEncoding::decodeUInt64(in, offset, raw)) return false;
+        if (raw > std::numeric_limits<Unsigned>::max()) return false;
+        value = static_cast<T>(static_cast<Unsigned>(raw));
+        return true;
+    }
+
+    static size_t encodedSize(const T& value) {
+        return network::VLEEncoding::encodedSize(static_cast<Unsigned>(value));
+    }
+};
+
+} // namespace core
+} // namespace omnisync
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 #include <functional> // for std::hash
+#include <vector>
+#include "flat_hash_map.hpp"
 
 namespace omnisync {
 namespace core {
@@ -40,23 +43,144 @@ struct OpID {
 
 /**
  * @brief The fundamental unit of the data structure (RGA Node).
- * Represents a single character insertion.
+ * Represents the insertion of a single element: a character for text,
+ * or any small value for other lists.
+ *
+ * @tparam T Element type (char for text, char32_t for code points, ...)
  */
-struct Atom {
+template <typename T>
+struct BasicAtom {
     OpID id;          // My unique ID
     OpID origin;      // The ID of the Atom strictly to my LEFT (Parent)
     
-    char content;     // The payload (e.g., 'A')
+    T content;        // The payload (e.g., 'A')
     bool is_deleted;  // If true, this is a "Tombstone" (Invisible, but kept for history)
 
     // Constructor for convenience
-    Atom(OpID _id, OpID _origin, char _content)
+    BasicAtom(OpID _id, OpID _origin, T _content)
         : id(_id), origin(_origin), content(_content), is_deleted(false) {}
         
     // Default constructor needed for some containers
-    Atom() : id({0,0}), origin({0,0}), content(0), is_deleted(true) {}
+    BasicAtom() : id({0,0}), origin({0,0}), content(), is_deleted(true) {}
 };
 
+using Atom = BasicAtom<char>;
+
+/**
+ * @brief Compact wire form of a range delete.
+ * Covers `length` atoms of one client with ids {client_id, start_clock + j * step}.
+ */
+struct DeleteSpan {
+    uint64_t client_id;
+    uint64_t start_clock;
+    uint64_t step;
+    uint64_t length;
+
+    OpID idAt(uint64_t j) const {
+        return {client_id, start_clock + j * step};
+    }
+
+    /**
+     * @brief Whether the span is non-empty and its last clock fits in 64 bits.
+     */
+    bool valid() const {
+        return step != 0 && length != 0 && length - 1 <= (UINT64_MAX - start_clock) / step;
+    }
+
+    /**
+     * @brief Number of leading ids with a clock at or below `clock`.
+     */
+    uint64_t countThrough(uint64_t clock) const {
+        if (start_clock > clock) return 0;
+        if (step == 0) return length;
+        return std::min(length, (clock - start_clock) / step + 1);
+    }
+
+    /**
+     * @brief Extend the span with `id` if it is the next id in the pattern.
+     */
+    bool extendWith(const OpID& id) {
+        if (id.client_id != client_id) return false;
+        uint64_t last = start_clock + (length - 1) * step;
+        if (id.clock <= last) return false;
+        if (length == 1) step = id.clock - last;
+        else if (id.clock - last != step) return false;
+        length++;
+        return true;
+    }
+};
+
+/**
+ * @brief A run of delete operations from one client.
+ * Op j has its own id {client_id, start_clock + j} and deletes target.idAt(j).
+ */
+struct DeleteOp {
+    uint64_t client_id;
+    uint64_t start_clock;
+    DeleteSpan target;
+
+    OpID idAt(uint64_t j) const {
+        return {client_id, start_clock + j};
+    }
+
+    uint64_t lastClock() const {
+        return start_clock + target.length - 1;
+    }
+
+    /**
+     * @brief Whether the record is well formed and every target is older
+     * than the op deleting it. A sender only deletes ids it already has,
+     * so a target past the op's own clock was never known to the sender.
+     */
+    bool valid() const {
+        if (!target.valid() || start_clock > UINT64_MAX - target.length) return false;
+        uint64_t last_target = target.start_clock + (target.length - 1) * target.step;
+        return target.start_clock < start_clock && last_target < lastClock();
+    }
+
+    /**
+     * @brief Ops [from, from + count) as a record of their own.
+     */
+    DeleteOp slice(uint64_t from, uint64_t count) const {
+        DeleteOp op = *this;
+        op.start_clock += from;
+        op.target.start_clock += from * target.step;
+        op.target.length = count;
+        return op;
+    }
+
+    /**
+     * @brief Append `next` if its ops follow on and its targets continue the span.
+     */
+    bool extendWith(const DeleteOp& next) {
+        const DeleteSpan& t = next.target;
+        if (next.client_id != client_id || next.start_clock != lastClock() + 1) return false;
+        if (t.client_id != target.client_id) return false;
+        uint64_t last = target.start_clock + (target.length - 1) * target.step;
+        if (t.start_clock <= last) return false;
+        uint64_t step = target.length > 1 ? target.step : t.start_clock - last;
+        if (t.start_clock - last != step || (t.length > 1 && t.step != step)) return false;
+        target.step = step;
+        target.length += t.length;
+        return true;
+    }
+};
+
+/**
+ * @brief Append the ops of one client's delete log (sorted by clock and
+ * disjoint) that come after `peer_time`, trimming a record the peer
+ * partly has.
+ */
+inline void appendUnseenDeleteOps(const std::vector<DeleteOp>& log, uint64_t peer_time, std::vector<DeleteOp>& out) {
+    auto it = std::upper_bound(log.begin(), log.end(), peer_time,
+                               [](uint64_t t, const DeleteOp& op) { return t < op.start_clock; });
+    if (it != log.begin() && std::prev(it)->lastClock() > peer_time) --it;
+    for (; it != log.end(); ++it) {
+        if (it->start_clock > peer_time) out.push_back(*it);
+        else out.push_back(it->slice(peer_time - it->start_clock + 1, it->lastClock() - peer_time));
+    }
+}
+
 } // namespace core
 } // namespace omnisync
 
@@ -64,9 +188,13 @@ struct Atom {
 namespace std {
     template<>
     struct hash<omnisync::core::OpID> {
+        using is_avalanching = void; // Safe for power-of-two tables as is
+
         size_t operator()(const omnisync::core::OpID& k) const {
-            // Simple hash combination
-            return std::hash<uint64_t>()(k.client_id) ^ (std::hash<uint64_t>()(k.clock) << 1);
+            // Spread the client over the word, fold in the clock, then mix so
+            // sequential clocks land in unrelated buckets
+            uint64_t h = k.clock ^ (k.client_id * 0x9E3779B97F4A7C15ULL);
+            return static_cast<size_t>(omnisync::core::detail::mixBits(h));
         }
     };
 }
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "sequence.hpp"
+#include "mpsc_queue.hpp"
+
+namespace omnisync {
+namespace core {
+
+/**
+ * @brief Many documents spread over a pool of worker threads.
+ *
+ * Each document lives on exactly one shard, picked by hashing its id,
+ * and each shard is served by one worker thread that owns its documents
+ * outright: no lock is taken on document data. Calls post a task to the
+ * shard's lock-free queue and return a std::future for the result, so
+ * every call on one document runs in the order it was made, and calls on
+ * documents in different shards run in parallel.
+ *
+ * Documents are created by the first call that writes to them; reads of
+ * a missing document see an empty one. Call close() before destroying a
+ * store that other threads may still be calling. Exceptions thrown by a task reach
+ * the caller through its future. A call made while its shard's queue is
+ * full sleeps until the worker makes room, and an idle worker sleeps
+ * until the next call; neither polls.
+ *
+ *   DocumentStore<> store(1);
+ *   store.applyDelta("doc-42", atoms);
+ *   std::string text = store.read("doc-42", [](const Sequence& d) { return d.toString(); }).get();
+ */
+template <typename Document = Sequence, typename Key = std::string>
+class DocumentStore {
+public:
+    using Atom = typename Document::Atom;
+
+    struct Config {
+        size_t workers = std::max(1u, std::thread::hardware_concurrency());
+        size_t queue_capacity = 16384;  // Pending calls per shard
+    };
+
+    explicit DocumentStore(uint64_t client_id) : DocumentStore(client_id, Config()) {}
+
+    DocumentStore(uint64_t client_id, Config config) {
+        size_t workers = std::max<size_t>(1, config.workers);
+        shards_.reserve(workers);
+        for (size_t i = 0; i < workers; i++) {
+            shards_.push_back(std::make_unique<Shard>(client_id, config.queue_capacity));
+        }
+        for (auto& shard : shards_) {
+            Shard* s = shard.get();
+            s->worker = std::thread([s] { s->run(); });
+        }
+    }
+
+    /**
+     * @brief close(), if it hasn't been called yet. Every thread calling
+     * into the store must be done with it first.
+     */
+    ~DocumentStore() {
+        close();
+    }
+
+    /**
+     * @brief Stop accepting calls, run every call already made, then stop
+     * the workers. Callers waiting for room in a full queue are woken and
+     * their calls run too; calls made after close() starts fail with
+     * broken_promise. Safe to call while other threads are making calls,
+     * but not from two threads at once.
+     */
+    void close() {
+        for (auto& shard : shards_) shard->stop();
+    }
+
+    DocumentStore(const DocumentStore&) = delete;
+    DocumentStore& operator=(const DocumentStore&) = delete;
+
+    size_t shardCount() const {
+        return shards_.size();
+    }
+
+    /**
+     * @brief Shard (and worker thread) that owns `id`.
+     */
+    size_t shardOf(const Key& id) const {
+        uint64_t h = static_cast<uint64_t>(std::hash<Key>()(id)) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<size_t>((h >> 32) % shards_.size());
+    }
+
+    /**
+     * @brief Run fn(document) on the owning worker, creating the document if needed.
+     * @return Future for fn's result.
+     */
+    template <typename Fn>
+    auto update(const Key& id, Fn&& fn) {
+        Shard& shard = *shards_[shardOf(id)];
+        return shard.submit([&shard, id, fn = std::forward<Fn>(fn)]() mutable {
+            return fn(shard.document(id));
+        });
+    }
+
+    /**
+     * @brief Run fn(document) on the owning worker without creating it.
+     * @return Future for fn's result.
+     */
+    template <typename Fn>
+    auto read(const Key& id, Fn&& fn) {
+        Shard& shard = *shards_[shardOf(id)];
+        return shard.submit([&shard, id, fn = std::forward<Fn>(fn)]() mutable {
+            return fn(static_cast<const Document&>(shard.find(id)));
+        });
+    }
+
+    std::future<DeltaStats> applyDelta(const Key& id, std::vector<Atom> atoms) {
+        return update(id, [atoms = std::move(atoms)](Document& doc) { return doc.applyDelta(atoms); });
+    }
+
+    std::future<void> applyDeleteOps(const Key& id, std::vector<DeleteOp> ops) {
+        return update(id, [ops = std::move(ops)](Document& doc) { doc.applyDeleteOps(ops); });
+    }
+
+    std::future<std::vector<Atom>> getDelta(const Key& id, VectorClock peer_state) {
+        return read(id, [peer = std::move(peer_state)](const Document& doc) { return doc.getDelta(peer); });
+    }
+
+    std::future<VectorClock> getVectorClock(const Key& id) {
+        return read(id, [](const Document& doc) { return doc.getVectorClock(); });
+    }
+
+    /**
+     * @brief Serialize a document with save(). A missing one saves as empty.
+     */
+    std::future<std::string> snapshot(const Key& id) {
+        return read(id, [](const Document& doc) {
+            std::ostringstream out;
+            doc.save(out);
+            return out.str();
+        });
+    }
+
+    /**
+     * @brief Replace a document with one from snapshot(), creating it if needed.
+     */
+    std::future<bool> restore(const Key& id, std::string bytes) {
+        return update(id, [bytes = std::move(bytes)](Document& doc) {
+            std::istringstream in(bytes);
+            return doc.load(in);
+        });
+    }
+
+    /**
+     * @brief Drop a document. The future is false if it didn't exist.
+     */
+    std::future<bool> erase(const Key& id) {
+        Shard& shard = *shards_[shardOf(id)];
+        return shard.submit([&shard, id]() { return shard.documents.erase(id) > 0; });
+    }
+
+    /**
+     * @brief Documents across all shards, counted after calls already made.
+     */
+    size_t documentCount() {
+        std::vector<std::future<size_t>> counts;
+        for (auto& shard : shards_) {
+            Shard* s = shard.get();
+            counts.push_back(s->submit([s]() { return s->documents.size(); }));
+        }
+        size_t total = 0;
+        for (auto& count : counts) total += count.get();
+        return total;
+    }
+
+private:
+    /**
+     * @brief One worker thread, its call queue and the documents it owns.
+     */
+    struct Shard {
+        uint64_t client_id;
+        std::unordered_map<Key, Document> documents;  // Touched only by `worker`
+        Document empty;                               // Stand-in for reads of missing ids
+        BoundedMPSCQueue<std::packaged_task<void()>> queue;
+        std::thread worker;
+
+        // Idle worker and callers waiting for room sleep here
+        QueueParking parking;
+        std::atomic<bool> stopping{false};  // Set under the parking lock
+        std::atomic<size_t> submitting{0};  // Callers inside submit(), drained before the worker exits
+
+        Shard(uint64_t client, size_t capacity) : client_id(client), empty(client), queue(capacity) {}
+
+        Document& document(const Key& id) {
+            auto it = documents.find(id);
+            if (it == documents.end()) it = documents.emplace(id, Document(client_id)).first;
+            return it->second;
+        }
+
+        const Document& find(const Key& id) const {
+            auto it = documents.find(id);
+            return it == documents.end() ? empty : it->second;
+        }
+
+        /**
+         * @brief Queue fn for the worker, sleeping while the queue is full.
+         * Once the shard is stopping, the future fails with broken_promise
+         * instead.
+         */
+        template <typename Fn>
+        auto submit(Fn&& fn) -> std::future<std::invoke_result_t<Fn&>> {
+            using Result = std::invoke_result_t<Fn&>;
+            submitting.fetch_add(1, std::memory_order_seq_cst);
+            if (stopping.load(std::memory_order_seq_cst)) {
+                submitting.fetch_sub(1, std::memory_order_release);
+                std::promise<Result> rejected;
+                rejected.set_exception(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+                return rejected.get_future();
+            }
+
+            std::packaged_task<Result()> typed(std::forward<Fn>(fn));
+            auto result = typed.get_future();
+            std::packaged_task<void()> task([typed = std::move(typed)]() mutable { typed(); });
+            if (!queue.tryPush(std::move(task))) {  // Moves only on success
+                parking.waitToPush([&] { return queue.tryPush(std::move(task)); });
+            }
+            parking.pushed();
+            submitting.fetch_sub(1, std::memory_order_release);
+            return result;
+        }
+
+        void run() {
+            std::packaged_task<void()> task;
+            while (true) {
+                if (queue.tryPop(task)) {
+                    parking.popped();
+                    task();
+                    continue;
+                }
+                if (stopping.load(std::memory_order_seq_cst)) break;
+
+                // Idle: sleep until a caller submits or stop() is called
+                parking.waitForWork([&] {
+                    return queue.readyToPop() || stopping.load(std::memory_order_relaxed);
+                });
+            }
+
+            // Stopping: run what is queued, and what callers that got past
+            // the stopping check in submit() are still pushing. Keep waking
+            // callers waiting for room, or they would never get in.
+            while (true) {
+                if (queue.tryPop(task)) {
+                    parking.popped();
+                    task();
+                    continue;
+                }
+                if (submitting.load(std::memory_order_seq_cst) == 0 && !queue.readyToPop()) break;
+                std::this_thread::yield();  // A caller is between its check and its push
+            }
+        }
+
+        void stop() {
+            parking.wakeConsumer([&] { stopping.store(true, std::memory_order_seq_cst); });
+            if (worker.joinable()) worker.join();
+        }
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+} // namespace core
+} // namespace omnisync
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace omnisync {
+namespace core {
+
+/**
+ * @brief Epoch-based reclamation for one writer and many readers.
+ *
+ * Readers pin the current epoch while they hold a pointer to shared data;
+ * pinning is one CAS on a per-slot cache line, with no lock and no shared
+ * counter. The writer retires objects it has unpublished, tagged with the
+ * epoch they were retired in, and frees them once every pinned reader has
+ * moved past that epoch.
+ *
+ * pin() may be called from any thread. retire() and reclaim() belong to
+ * the single writer.
+ */
+class EpochManager {
+    static constexpr uint64_t kIdle = 0;
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{kIdle};
+    };
+
+    struct Retired {
+        uint64_t epoch;
+        void* object;
+        void (*destroy)(void*);
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t slot_count_;
+    std::atomic<uint64_t> epoch_{1};
+    std::vector<Retired> retired_;
+
+public:
+    /**
+     * @brief Keeps the epoch pinned, and everything read under it alive.
+     */
+    class Guard {
+        Slot* slot_ = nullptr;
+
+        explicit Guard(Slot* slot) : slot_(slot) {}
+        friend class EpochManager;
+
+    public:
+        Guard() = default;
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        Guard(Guard&& other) noexcept : slot_(other.slot_) { other.slot_ = nullptr; }
+        Guard& operator=(Guard&& other) noexcept {
+            if (this != &other) {
+                release();
+                slot_ = other.slot_;
+                other.slot_ = nullptr;
+            }
+            return *this;
+        }
+        ~Guard() { release(); }
+
+        void release() {
+            if (slot_) slot_->epoch.store(kIdle, std::memory_order_release);
+            slot_ = nullptr;
+        }
+    };
+
+    /**
+     * @param reader_slots Readers that can hold a pin at the same time;
+     *        further readers spin until a slot frees up.
+     */
+    explicit EpochManager(size_t reader_slots = 64)
+        : slots_(new Slot[reader_slots ? reader_slots : 1]), slot_count_(reader_slots ? reader_slots : 1) {}
+
+    ~EpochManager() {
+        for (const Retired& r : retired_) r.destroy(r.object);
+    }
+
+    EpochManager(const EpochManager&) = delete;
+    EpochManager& operator=(const EpochManager&) = delete;
+
+    /**
+     * @brief Pin the current epoch. Load shared pointers after this returns.
+     */
+    Guard pin() {
+        size_t start = std::hash<std::thread::id>()(std::this_thread::get_id()) % slot_count_;
+        while (true) {
+            for (size_t i = 0; i < slot_count_; i++) {
+                Slot& slot = slots_[(start + i) % slot_count_];
+                uint64_t idle = kIdle;
+                if (slot.epoch.load(std::memory_order_relaxed) == kIdle &&
+                    slot.epoch.compare_exchange_strong(idle, epoch_.load(std::memory_order_seq_cst),
+                                                       std::memory_order_seq_cst)) {
+                    return Guard(&slot);
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * @brief Free `object` once no reader pinned before now can still see it.
+     * Unpublish it first.
+     */
+    template <typename U>
+    void retire(const U* object) {
+        uint64_t epoch = epoch_.fetch_add(1, std::memory_order_seq_cst);
+        retired_.push_back({epoch, const_cast<U*>(object), [](void* p) { delete static_cast<U*>(p); }});
+    }
+
+    /**
+     * @brief Free retired objects no pinned reader can reach.
+     * @return Number of objects freed.
+     */
+    size_t reclaim() {
+        if (retired_.empty()) return 0;
+        uint64_t oldest = UINT64_MAX;
+        for (size_t i = 0; i < slot_count_; i++) {
+            uint64_t pinned = slots_[i].epoch.load(std::memory_order_seq_cst);
+            if (pinned != kIdle && pinned < oldest) oldest = pinned;
+        }
+
+        size_t kept = 0;
+        size_t freed = 0;
+        for (const Retired& r : retired_) {
+            if (r.epoch < oldest) {
+                r.destroy(r.object);
+                freed++;
+            } else {
+                retired_[kept++] = r;
+            }
+        }
+        retired_.resize(kept);
+        return freed;
+    }
+
+    /**
+     * @brief Retired objects still waiting for readers.
+     */
+    size_t pending() const {
+        return retired_.size();
+    }
+};
+
+} // namespace core
+} // namespace omnisync
@@ -0,0 +1,353 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace omnisync {
+namespace core {
+
+namespace detail {
+
+/**
+ * @brief Finalizer from MurmurHash3: spreads every input bit over the word.
+ */
+inline uint64_t mixBits(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+template <typename Hash, typename = void>
+struct IsAvalanching : std::false_type {};
+
+template <typename Hash>
+struct IsAvalanching<Hash, std::void_t<typename Hash::is_avalanching>> : std::true_type {};
+
+} // namespace detail
+
+/**
+ * @brief Open-addressing hash map with robin-hood probing.
+ *
+ * Entries live inline in one flat array, so a lookup touches one or two
+ * cache lines instead of chasing bucket nodes. Each slot carries its probe
+ * distance; inserts steal slots from entries closer to home, which keeps
+ * probe sequences short, and erases shift the following run back instead
+ * of leaving tombstones.
+ *
+ * Hashes that do not declare `is_avalanching` (e.g. the identity
+ * `std::hash<uint64_t>`) are passed through an extra mixing step, because
+ * slots are picked from the low bits only.
+ *
+ * Iterators and references are invalidated by any insert or erase.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap {
+public:
+    using value_type = std::pair<Key, Value>;
+
+private:
+    static constexpr size_t kMinCapacity = 16;
+    static constexpr uint32_t kMaxDistance = 255;  // dist_ is one byte
+
+    value_type* slots_ = nullptr;
+    std::unique_ptr<uint8_t[]> dist_;  // 0 = empty, else probe distance + 1
+    size_t capacity_ = 0;
+    size_t size_ = 0;
+    Hash hash_;
+    KeyEqual equal_;
+
+    size_t home(const Key& key) const {
+        uint64_t h = static_cast<uint64_t>(hash_(key));
+        if (!detail::IsAvalanching<Hash>::value) h = detail::mixBits(h);
+        return static_cast<size_t>(h) & (capacity_ - 1);
+    }
+
+    size_t findSlot(const Key& key) const {
+        if (size_ == 0) return capacity_;
+        size_t pos = home(key);
+        for (uint32_t d = 1; dist_[pos] >= d; d++) {
+            if (equal_(slots_[pos].first, key)) return pos;
+            pos = (pos + 1) & (capacity_ - 1);
+        }
+        return capacity_;
+    }
+
+    void allocate(size_t capacity) {
+        slots_ = std::allocator<value_type>().allocate(capacity);
+        dist_.reset(new uint8_t[capacity]());
+        capacity_ = capacity;
+    }
+
+    void deallocate() {
+        if (!slots_) return;
+        clear();
+        std::allocator<value_type>().deallocate(slots_, capacity_);
+        slots_ = nullptr;
+        dist_.reset();
+        capacity_ = 0;
+    }
+
+    void rehash(size_t capacity) {
+        value_type* old_slots = slots_;
+        std::unique_ptr<uint8_t[]> old_dist = std::move(dist_);
+        size_t old_capacity = capacity_;
+
+        allocate(capacity);
+        size_ = 0;
+        for (size_t i = 0; i < old_capacity; i++) {
+            if (!old_dist[i]) continue;
+            place(std::move(old_slots[i]));
+            old_slots[i].~value_type();
+        }
+        if (old_slots) std::allocator<value_type>().deallocate(old_slots, old_capacity);
+    }
+
+    /**
+     * @brief Robin-hood insert of a key known to be absent; returns its slot.
+     */
+    size_t place(value_type&& entry) {
+        if (capacity_ == 0 || (size_ + 1) * 8 > capacity_ * 7) {
+            rehash(capacity_ ? capacity_ * 2 : kMinCapacity);
+        }
+
+        Key key = entry.first;
+        value_type carry(std::move(entry));
+        size_t pos = home(carry.first);
+        size_t placed = capacity_;
+        uint32_t d = 1;
+        while (true) {
+            if (!dist_[pos]) {
+                ::new (static_cast<void*>(slots_ + pos)) value_type(std::move(carry));
+                dist_[pos] = static_cast<uint8_t>(d);
+                size_++;
+                return placed == capacity_ ? pos : placed;
+            }
+            if (dist_[pos] < d) {
+                std::swap(carry, slots_[pos]);
+                uint8_t displaced = dist_[pos];
+                dist_[pos] = static_cast<uint8_t>(d);
+                d = displaced;
+                if (placed == capacity_) placed = pos;
+            }
+            pos = (pos + 1) & (capacity_ - 1);
+            if (++d == kMaxDistance) {
+                // Pathological clustering: grow and re-place the displaced entry
+                rehash(capacity_ * 2);
+                place(std::move(carry));
+                return findSlot(key);
+            }
+        }
+    }
+
+    void eraseSlot(size_t pos) {
+        slots_[pos].~value_type();
+        dist_[pos] = 0;
+        size_--;
+
+        // Backward-shift the rest of the probe run
+        size_t next = (pos + 1) & (capacity_ - 1);
+        while (dist_[next] > 1) {
+            ::new (static_cast<void*>(slots_ + pos)) value_type(std::move(slots_[next]));
+            slots_[next].~value_type();
+            dist_[pos] = static_cast<uint8_t>(dist_[next] - 1);
+            dist_[next] = 0;
+            pos = next;
+            next = (next + 1) & (capacity_ - 1);
+        }
+    }
+
+    template <bool Const>
+    class Iter {
+        using Table = std::conditional_t<Const, const FlatHashMap, FlatHashMap>;
+        Table* table_;
+        size_t pos_;
+
+        void skipEmpty() {
+            while (pos_ < table_->capacity_ && !table_->dist_[pos_]) pos_++;
+        }
+
+        friend class FlatHashMap;
+
+    public:
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+
+        Iter(Table* table, size_t pos) : table_(table), pos_(pos) {
+            skipEmpty();
+        }
+
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        Iter(const Iter<false>& other) : table_(other.table_), pos_(other.pos_) {}
+
+        reference operator*() const { return table_->slots_[pos_]; }
+        pointer operator->() const { return table_->slots_ + pos_; }
+
+        Iter& operator++() {
+            pos_++;
+            skipEmpty();
+            return *this;
+        }
+
+        bool operator==(const Iter& other) const { return pos_ == other.pos_; }
+        bool operator!=(const Iter& other) const { return pos_ != other.pos_; }
+
+        friend class Iter<!Const>;
+    };
+
+public:
+    using iterator = Iter<false>;
+    using const_iterator = Iter<true>;
+
+    FlatHashMap() = default;
+
+    ~FlatHashMap() {
+        deallocate();
+    }
+
+    FlatHashMap(const FlatHashMap& other) : hash_(other.hash_), equal_(other.equal_) {
+        reserve(other.size_);
+        for (const auto& entry : other) place(value_type(entry));
+    }
+
+    FlatHashMap& operator=(const FlatHashMap& other) {
+        if (this != &other) {
+            FlatHashMap copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    FlatHashMap(FlatHashMap&& other) noexcept {
+        swap(other);
+    }
+
+    FlatHashMap& operator=(FlatHashMap&& other) noexcept {
+        if (this != &other) {
+            deallocate();
+            swap(other);
+        }
+        return *this;
+    }
+
+    void swap(FlatHashMap& other) noexcept {
+        std::swap(slots_, other.slots_);
+        std::swap(dist_, other.dist_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(size_, other.size_);
+        std::swap(hash_, other.hash_);
+        std::swap(equal_, other.equal_);
+    }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, capacity_); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, capacity_); }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const { return capacity_; }
+
+    iterator find(const Key& key) {
+        return iterator(this, findSlot(key));
+    }
+
+    const_iterator find(const Key& key) const {
+        return const_iterator(this, findSlot(key));
+    }
+
+    size_t count(const Key& key) const {
+        return findSlot(key) != capacity_ ? 1 : 0;
+    }
+
+    /**
+     * @brief Insert `key` with a default value unless it is present.
+     * @return Iterator to the entry and whether it was inserted.
+     */
+    std::pair<iterator, bool> tryEmplace(const Key& key) {
+        size_t pos = findSlot(key);
+        if (pos != capacity_) return {iterator(this, pos), false};
+        pos = place(value_type(key, Value()));
+        return {iterator(this, pos), true};
+    }
+
+    std::pair<iterator, bool> insert(const value_type& entry) {
+        size_t pos = findSlot(entry.first);
+        if (pos != capacity_) return {iterator(this, pos), false};
+        pos = place(value_type(entry));
+        return {iterator(this, pos), true};
+    }
+
+    Value& operator[](const Key& key) {
+        return tryEmplace(key).first->second;
+    }
+
+    size_t erase(const Key& key) {
+        size_t pos = findSlot(key);
+        if (pos == capacity_) return 0;
+        eraseSlot(pos);
+        return 1;
+    }
+
+    void erase(const_iterator it) {
+        eraseSlot(it.pos_);
+    }
+
+    void clear() {
+        for (size_t i = 0; i < capacity_; i++) {
+            if (dist_[i]) {
+                slots_[i].~value_type();
+                dist_[i] = 0;
+            }
+        }
+        size_ = 0;
+    }
+
+    void reserve(size_t count) {
+        size_t capacity = kMinCapacity;
+        while (capacity * 7 < count * 8) capacity *= 2;
+        if (capacity > capacity_) rehash(capacity);
+    }
+
+    /**
+     * @brief Approximate heap footprint of the table.
+     */
+    size_t memoryBytes() const {
+        return capacity_ * (sizeof(value_type) + 1);
+    }
+};
+
+/**
+ * @brief Open-addressing hash set built on FlatHashMap.
+ */
+template <typename Key, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class FlatHashSet {
+    struct Empty {};
+    FlatHashMap<Key, Empty, Hash, KeyEqual> map_;
+
+public:
+    bool insert(const Key& key) { return map_.tryEmplace(key).second; }
+    size_t erase(const Key& key) { return map_.erase(key); }
+    size_t count(const Key& key) const { return map_.count(key); }
+    size_t size() const { return map_.size(); }
+    bool empty() const { return map_.empty(); }
+    void clear() { map_.clear(); }
+    void reserve(size_t count) { map_.reserve(count); }
+    size_t memoryBytes() const { return map_.memoryBytes(); }
+
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const auto& entry : map_) fn(entry.first);
+    }
+};
+
+} // namespace core
+} // namespace omnisync
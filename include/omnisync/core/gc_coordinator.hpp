@@ -199,10 +199,11 @@ public:
 
     /**
      * @brief Perform coordinated GC on a document
-     * @param doc The document to garbage collect
+     * @param doc The document to garbage collect (any BasicSequence)
      * @return Number of tombstones removed
      */
-    size_t performCoordinatedGC(Sequence& doc) {
+    template <typename Document>
+    size_t performCoordinatedGC(Document& doc) {
         VectorClock frontier = computeStableFrontier();
         size_t removed = doc.garbageCollect(frontier);
         
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <variant>
+#include <vector>
+#include "sequence.hpp"
+#include "mpsc_queue.hpp"
+
+namespace omnisync {
+namespace core {
+
+/**
+ * @brief Feeds a document from many threads through one apply thread.
+ *
+ * Network threads push decoded ops into a bounded lock-free queue and go
+ * back to their sockets. A dedicated thread drains the queue in batches:
+ * each batch's inserts go through one applyDelta() and its delete ops
+ * through one applyDeleteOps(), so the per-op cost is the merge itself.
+ * While the ingest runs, the apply thread owns the document; read it
+ * from the `after_batch` callback (e.g. to publish a VersionedDocument)
+ * or after stop().
+ *
+ * When the queue is full, push() sleeps until the apply thread makes
+ * room (backpressure on the producer) and tryPush() returns false so the
+ * caller can drop or defer. An idle apply thread sleeps until the next
+ * push; neither side polls.
+ */
+template <typename Document = Sequence>
+class IngestQueue {
+public:
+    using Atom = typename Document::Atom;
+    using Op = std::variant<Atom, DeleteOp>;
+
+    struct Config {
+        size_t capacity = 65536;  // Ops the queue holds (rounded up to a power of two)
+        size_t max_batch = 4096;  // Ops per apply pass
+        std::function<void(Document&, const DeltaStats&)> after_batch;  // Runs on the apply thread
+    };
+
+    struct Stats {
+        uint64_t pushed = 0;         // Ops accepted
+        uint64_t applied = 0;        // Ops handed to the document
+        uint64_t batches = 0;        // Apply passes
+        uint64_t rejected = 0;       // tryPush calls that found the queue full
+        uint64_t waits = 0;          // push calls that had to wait for room
+        uint64_t largest_batch = 0;
+    };
+
+    explicit IngestQueue(Document& doc) : IngestQueue(doc, Config()) {}
+
+    IngestQueue(Document& doc, Config config)
+        : doc_(doc), config_(std::move(config)), queue_(config_.capacity) {
+        if (config_.max_batch == 0) config_.max_batch = 1;
+        worker_ = std::thread([this] { run(); });
+    }
+
+    ~IngestQueue() {
+        stop();
+    }
+
+    IngestQueue(const IngestQueue&) = delete;
+    IngestQueue& operator=(const IngestQueue&) = delete;
+
+    /**
+     * @brief Enqueue an op, or return false at once if the queue is full.
+     */
+    template <typename O>
+    bool tryPush(O&& op) {
+        if (!queue_.tryPush(Op(std::forward<O>(op)))) {
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        pushed_.fetch_add(1, std::memory_order_release);
+        parking_.pushed();
+        return true;
+    }
+
+    /**
+     * @brief Enqueue an op, sleeping while the queue is full.
+     */
+    template <typename O>
+    void push(O&& op) {
+        Op item(std::forward<O>(op));
+        if (!queue_.tryPush(std::move(item))) {  // Moves only on success
+            waits_.fetch_add(1, std::memory_order_relaxed);
+            parking_.waitToPush([&] { return queue_.tryPush(std::move(item)); });
+        }
+        pushed_.fetch_add(1, std::memory_order_release);
+        parking_.pushed();
+    }
+
+    /**
+     * @brief Enqueue a batch of atoms (e.g. one decoded packet), waiting for room.
+     */
+    void pushAll(const std::vector<Atom>& atoms) {
+        for (const Atom& atom : atoms) push(atom);
+    }
+
+    void pushAll(const std::vector<DeleteOp>& ops) {
+        for (const DeleteOp& op : ops) push(op);
+    }
+
+    /**
+     * @brief Wait until every op pushed before this call has been applied.
+     */
+    void flush() {
+        // Wait for the queue position, not the pushed_ count: a producer
+        // that enqueued earlier may not have counted its op yet, and the
+        // apply thread pops positions in order, so applied_ reaching the
+        // tail means everything below it has been applied
+        uint64_t target = queue_.claimed();
+        std::unique_lock<std::mutex> lock(mutex_);
+        drained_.wait(lock, [&] { return applied_.load(std::memory_order_acquire) >= target || !running_; });
+    }
+
+    /**
+     * @brief Apply what is queued, then stop the apply thread.
+     * Producers must have stopped pushing.
+     */
+    void stop() {
+        bool first = false;
+        parking_.wakeConsumer([&] { first = !stopping_.exchange(true, std::memory_order_relaxed); });
+        if (first) worker_.join();
+    }
+
+    Stats getStats() const {
+        Stats stats;
+        stats.pushed = pushed_.load(std::memory_order_relaxed);
+        stats.applied = applied_.load(std::memory_order_relaxed);
+        stats.batches = batches_.load(std::memory_order_relaxed);
+        stats.rejected = rejected_.load(std::memory_order_relaxed);
+        stats.waits = waits_.load(std::memory_order_relaxed);
+        stats.largest_batch = largest_batch_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    size_t queuedApprox() const {
+        return queue_.sizeApprox();
+    }
+
+private:
+    Document& doc_;
+    Config config_;
+    BoundedMPSCQueue<Op> queue_;
+    std::thread worker_;
+
+    std::atomic<uint64_t> pushed_{0};
+    std::atomic<uint64_t> applied_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> waits_{0};
+    std::atomic<uint64_t> largest_batch_{0};
+
+    // Idle apply thread and producers waiting for room sleep here
+    QueueParking parking_;
+    std::atomic<bool> stopping_{false};  // Set under the parking lock
+
+    // flush() waits here for applied_ to catch up
+    std::mutex mutex_;
+    std::condition_variable drained_;
+    bool running_ = true;
+
+    /**
+     * @brief Drain up to max_batch ops into one insert pass and one delete pass.
+     */
+    size_t applyBatch(std::vector<Op>& batch, std::vector<Atom>& inserts, std::vector<DeleteOp>& deletes) {
+        batch.clear();
+        size_t count = queue_.popBatch(batch, config_.max_batch);
+        if (count == 0) return 0;
+        parking_.popped();
+
+        inserts.clear();
+        deletes.clear();
+        for (Op& op : batch) {
+            if (auto* atom = std::get_if<Atom>(&op)) inserts.push_back(*atom);
+            else deletes.push_back(std::get<DeleteOp>(op));
+        }
+
+        // Inserts first, so deletes in the same batch find their targets
+        DeltaStats stats;
+        if (!inserts.empty()) stats = doc_.applyDelta(inserts);
+        if (!deletes.empty()) doc_.applyDeleteOps(deletes);
+        if (config_.after_batch) config_.after_batch(doc_, stats);
+
+        batches_.fetch_add(1, std::memory_order_relaxed);
+        if (count > largest_batch_.load(std::memory_order_relaxed)) {
+            largest_batch_.store(count, std::memory_order_relaxed);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);  // So flush() can't miss the update
+            applied_.fetch_add(count, std::memory_order_release);
+        }
+        drained_.notify_all();
+        return count;
+    }
+
+    void run() {
+        std::vector<Op> batch;
+        std::vector<Atom> inserts;
+        std::vector<DeleteOp> deletes;
+        batch.reserve(config_.max_batch);
+
+        while (true) {
+            if (applyBatch(batch, inserts, deletes) > 0) continue;
+            if (stopping_.load(std::memory_order_relaxed)) break;
+
+            // Idle: sleep until a producer pushes or stop() is called
+            parking_.waitForWork([&] {
+                return queue_.readyToPop() || stopping_.load(std::memory_order_relaxed);
+            });
+        }
+
+        // Stopping: apply whatever is left
+        while (applyBatch(batch, inserts, deletes) > 0) {
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+        drained_.notify_all();
+    }
+};
+
+} // namespace core
+} // namespace omnisync
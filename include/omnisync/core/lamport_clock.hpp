@@ -80,5 +80,27 @@ public:
     }
 };
 
+/**
+ * @brief LamportClock without atomics, for clocks touched by one thread.
+ * Same rules and interface; tick and merge are plain loads and stores.
+ */
+class PlainLamportClock {
+private:
+    uint64_t counter = 0;
+
+public:
+    uint64_t peek() const {
+        return counter;
+    }
+
+    uint64_t tick() {
+        return ++counter;
+    }
+
+    void merge(uint64_t received_time) {
+        counter = std::max(counter, received_time) + 1;
+    }
+};
+
 } // namespace core
 } // namespace omnisync
@@ -0,0 +1,97 @@
+#ifndef OMNISYNC_CORE_MAPPED_DOCUMENT_HPP
+#define OMNISYNC_CORE_MAPPED_DOCUMENT_HPP
+
+#include <memory>
+#include <string>
+#include "sequence.hpp"
+#include "snapshot_view.hpp"
+
+namespace omnisync::core {
+
+/**
+ * @brief A document served from a mapped snapshot until someone edits it.
+ *
+ * Reads go straight to the mapped file. The first call to edit() builds a
+ * mutable Sequence from the snapshot and drops the mapping; from then on
+ * every call goes to the Sequence. A relay can keep many idle documents
+ * open this way and pay for deserialization only on the ones that change.
+ *
+ * Usage:
+ * ```cpp
+ * std::ofstream out("doc.omnm", std::ios::binary);
+ * doc.saveSnapshot(out);
+ *
+ * MappedDocument mapped;
+ * if (mapped.open("doc.omnm")) {
+ *     std::string view = mapped.substring(0, 4096);   // No parsing
+ *     mapped.edit().localInsert(0, '!');              // Promotes once
+ * }
+ * ```
+ */
+class MappedDocument {
+public:
+    MappedDocument() = default;
+
+    /**
+     * @brief Map a snapshot written by Sequence::saveSnapshot().
+     * @return false if the file is missing or not a valid snapshot
+     */
+    bool open(const std::string& path) {
+        doc_.reset();
+        if (!file_.open(path)) return false;
+        if (!view_.open(file_.data(), file_.size())) {
+            file_.close();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief True once edit() has built the mutable document.
+     */
+    bool isPromoted() const {
+        return doc_ != nullptr;
+    }
+
+    /**
+     * @brief The mutable document, built from the snapshot on first use.
+     */
+    Sequence& edit() {
+        if (!doc_) {
+            doc_ = std::make_unique<Sequence>(view_.valid() ? view_.clientId() : 0);
+            if (view_.valid()) doc_->load(view_);
+            view_ = SnapshotView();
+            file_.close();
+        }
+        return *doc_;
+    }
+
+    size_t length() const {
+        return doc_ ? doc_->length() : view_.length();
+    }
+
+    OpID idAt(size_t literal_index) const {
+        return doc_ ? doc_->idAt(literal_index) : view_.idAt(literal_index);
+    }
+
+    std::string substring(size_t literal_index, size_t len) const {
+        return doc_ ? doc_->substring(literal_index, len) : view_.substring(literal_index, len);
+    }
+
+    std::string toString() const {
+        return doc_ ? doc_->toString() : view_.toString();
+    }
+
+    VectorClock getVectorClock() const {
+        return doc_ ? doc_->getVectorClock() : view_.vectorClock();
+    }
+
+private:
+    MappedFile file_;
+    SnapshotView view_;
+    std::unique_ptr<Sequence> doc_;
+};
+
+} // namespace omnisync::core
+
+#endif // OMNISYNC_CORE_MAPPED_DOCUMENT_HPP
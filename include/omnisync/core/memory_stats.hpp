@@ -16,12 +16,15 @@ struct MemoryStats {
     size_t tombstone_count = 0;
     size_t orphan_count = 0;
     size_t delete_buffer_count = 0;
+    size_t run_count = 0;          // Run-length encoded id/origin runs
+    size_t delete_op_count = 0;    // Range-compressed delete-log records
     
     // Memory breakdown
     size_t atom_list_bytes = 0;
     size_t index_map_bytes = 0;
     size_t orphan_buffer_bytes = 0;
     size_t vector_clock_bytes = 0;
+    size_t delete_log_bytes = 0;
     
     // Histograms (atom age distribution)
     std::map<size_t, size_t> atom_age_histogram;      // age_bucket -> count
@@ -51,12 +54,21 @@ struct MemoryStats {
     };
     
     GCStats gc_stats;
+
+    // Orphan buffer activity
+    struct OrphanStats {
+        size_t buffered = 0;  // Atoms that waited for a missing origin
+        size_t evicted = 0;   // Dropped to make room in a full buffer
+        size_t expired = 0;   // Dropped for exceeding max_orphan_age
+    };
+
+    OrphanStats orphan_stats;
     
     /**
      * @brief Calculate total memory usage
      */
     size_t total_bytes() const {
-        return atom_list_bytes + index_map_bytes + orphan_buffer_bytes + vector_clock_bytes;
+        return atom_list_bytes + index_map_bytes + orphan_buffer_bytes + vector_clock_bytes + delete_log_bytes;
     }
     
     /**
@@ -65,13 +77,17 @@ struct MemoryStats {
     void print() const {
         std::cout << "Memory Statistics:\n";
         std::cout << "  Atoms: " << atom_count << " (" << tombstone_count << " tombstones)\n";
-        std::cout << "  Orphans: " << orphan_count << "\n";
+        std::cout << "  Runs: " << run_count << "\n";
+        std::cout << "  Orphans: " << orphan_count << " (" << orphan_stats.evicted << " evicted, "
+                  << orphan_stats.expired << " expired)\n";
         std::cout << "  Delete Buffer: " << delete_buffer_count << "\n";
+        std::cout << "  Delete Log: " << delete_op_count << " records\n";
         std::cout << "  Total Memory: " << total_bytes() / 1024 << " KB\n";
         std::cout << "    - Atom List: " << atom_list_bytes / 1024 << " KB\n";
         std::cout << "    - Index Map: " << index_map_bytes / 1024 << " KB\n";
         std::cout << "    - Orphan Buffer: " << orphan_buffer_bytes / 1024 << " KB\n";
         std::cout << "    - Vector Clock: " << vector_clock_bytes / 1024 << " KB\n";
+        std::cout << "    - Delete Log: " << delete_log_bytes / 1024 << " KB\n";
         
         if (gc_stats.total_gc_runs > 0) {
             std::cout << "\nGC Performance:\n";
@@ -119,6 +135,19 @@ struct MemoryStats {
     }
 };
 
+/**
+ * @brief Counters for one Sequence::applyDelta batch
+ */
+struct DeltaStats {
+    size_t received = 0;       // Atoms in the batch
+    size_t applied = 0;        // Atoms placed (includes orphans the batch unblocked)
+    size_t duplicates = 0;     // Atoms already present
+    size_t orphaned = 0;       // Growth of the orphan buffer
+    size_t tombstones = 0;     // Deletions applied
+    size_t gc_removed = 0;     // Tombstones dropped by the deferred auto-GC
+    uint64_t apply_time_us = 0;
+};
+
 } // namespace omnisync::core
 
 #endif // OMNISYNC_CORE_MEMORY_STATS_HPP
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace omnisync {
+namespace core {
+
+/**
+ * @brief Bounded lock-free queue for many producers and one consumer.
+ *
+ * A ring of cells, each tagged with a sequence number that says whether
+ * it is free for the producer claiming that position or holds a value
+ * for the consumer (Vyukov's bounded queue). Producers claim positions
+ * with one CAS on the shared tail; the consumer owns the head and never
+ * touches a shared counter. tryPush fails instead of waiting when the
+ * ring is full, so callers choose how to apply backpressure.
+ */
+template <typename T>
+class BoundedMPSCQueue {
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> tail_{0};  // Next position producers claim
+    alignas(64) std::atomic<size_t> head_{0};  // Next position the consumer reads (consumer writes)
+
+    static size_t roundUp(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        return size;
+    }
+
+public:
+    /**
+     * @param capacity Slots in the ring, rounded up to a power of two.
+     */
+    explicit BoundedMPSCQueue(size_t capacity)
+        : cells_(new Cell[roundUp(capacity)]), mask_(roundUp(capacity) - 1) {
+        for (size_t i = 0; i <= mask_; i++) cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    BoundedMPSCQueue(const BoundedMPSCQueue&) = delete;
+    BoundedMPSCQueue& operator=(const BoundedMPSCQueue&) = delete;
+
+    size_t capacity() const {
+        return mask_ + 1;
+    }
+
+    /**
+     * @brief Enqueue from any thread. False if the queue is full.
+     */
+    template <typename U>
+    bool tryPush(U&& value) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;  // The consumer hasn't freed this cell yet
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::forward<U>(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Dequeue on the consumer thread. False if nothing is ready.
+     */
+    bool tryPop(T& out) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        Cell& cell = cells_[head & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != head + 1) return false;
+        out = std::move(cell.value);
+        cell.sequence.store(head + mask_ + 1, std::memory_order_release);
+        head_.store(head + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Dequeue up to `max` values onto `out` on the consumer thread.
+     * @return Number of values appended.
+     */
+    size_t popBatch(std::vector<T>& out, size_t max) {
+        size_t popped = 0;
+        T value;
+        while (popped < max && tryPop(value)) {
+            out.push_back(std::move(value));
+            popped++;
+        }
+        return popped;
+    }
+
+    /**
+     * @brief True if the next tryPop would succeed. Consumer thread only.
+     */
+    bool readyToPop() const {
+        size_t head = head_.load(std::memory_order_relaxed);
+        return cells_[head & mask_].sequence.load(std::memory_order_acquire) == head + 1;
+    }
+
+    /**
+     * @brief Positions claimed by producers so far. Every push that
+     * returned before this call holds a position below the result, and the
+     * consumer pops positions in order.
+     */
+    size_t claimed() const {
+        return tail_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Values claimed by producers and not yet popped (approximate).
+     */
+    size_t sizeApprox() const {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+};
+
+/**
+ * @brief Sleep and wake-up for the two ends of a BoundedMPSCQueue.
+ *
+ * The consumer sleeps while the queue is empty and producers sleep while
+ * it is full; nobody polls. A side about to sleep announces it, issues a
+ * seq_cst fence and re-checks the queue; the other side fences between
+ * its push (or pop) and its check for sleepers. So at least one of the
+ * two sees the other, and a wake-up cannot be lost.
+ *
+ *   Producer:  if (!queue.tryPush(v)) parking.waitToPush([&] { return queue.tryPush(v); });
+ *              parking.pushed();
+ *   Consumer:  if (queue.tryPop(v)) { parking.popped(); ... }
+ *              else parking.waitForWork([&] { return queue.readyToPop() || stopping; });
+ */
+class QueueParking {
+public:
+    /**
+     * @brief Producer: call after every successful push.
+     */
+    void pushed() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumer_waiting_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            consumer_ready_.notify_one();
+        }
+    }
+
+    /**
+     * @brief Producer: sleep until try_push() succeeds (the queue was full).
+     */
+    template <typename TryPush>
+    void waitToPush(TryPush&& try_push) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        producers_waiting_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        not_full_.wait(lock, try_push);
+        producers_waiting_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Consumer: call after popping, to wake producers waiting for room.
+     */
+    void popped() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (producers_waiting_.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            not_full_.notify_all();
+        }
+    }
+
+    /**
+     * @brief Consumer: sleep until ready() holds (work queued, or a stop request).
+     */
+    template <typename Ready>
+    void waitForWork(Ready&& ready) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        consumer_waiting_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        consumer_ready_.wait(lock, ready);
+        consumer_waiting_.store(false, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Run fn() under the lock, then wake the consumer so it re-checks
+     * its condition (e.g. fn sets a stop flag).
+     */
+    template <typename Fn>
+    void wakeConsumer(Fn&& fn) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            fn();
+        }
+        consumer_ready_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable consumer_ready_;
+    std::condition_variable not_full_;
+    std::atomic<bool> consumer_waiting_{false};
+    std::atomic<size_t> producers_waiting_{0};
+};
+
+} // namespace core
+} // namespace omnisync
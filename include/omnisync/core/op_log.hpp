@@ -0,0 +1,519 @@
+#ifndef OMNISYNC_CORE_OP_LOG_HPP
+#define OMNISYNC_CORE_OP_LOG_HPP
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+    #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "sequence.hpp"
+#include "../network/binary_packer.hpp"
+
+namespace omnisync::core {
+
+/**
+ * @brief Append-only file whose writes can be flushed to stable storage.
+ */
+class DurableFile {
+public:
+    DurableFile() = default;
+    ~DurableFile() { close(); }
+
+    DurableFile(const DurableFile&) = delete;
+    DurableFile& operator=(const DurableFile&) = delete;
+
+    /**
+     * @brief Open `path` for appending, creating it if needed.
+     */
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        handle_ = CreateFileA(path.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ, nullptr,
+                              OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        return handle_ != INVALID_HANDLE_VALUE;
+#else
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        return fd_ >= 0;
+#endif
+    }
+
+    bool isOpen() const {
+#ifdef _WIN32
+        return handle_ != INVALID_HANDLE_VALUE;
+#else
+        return fd_ >= 0;
+#endif
+    }
+
+    bool append(const uint8_t* data, size_t size) {
+        if (!isOpen()) return false;
+        while (size > 0) {
+#ifdef _WIN32
+            DWORD chunk = static_cast<DWORD>(std::min<size_t>(size, 1u << 30));
+            DWORD written = 0;
+            if (!WriteFile(handle_, data, chunk, &written, nullptr)) return false;
+#else
+            ssize_t written = ::write(fd_, data, size);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+#endif
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Block until everything appended so far is on stable storage.
+     */
+    bool sync() {
+        if (!isOpen()) return false;
+#ifdef _WIN32
+        return FlushFileBuffers(handle_) != 0;
+#elif defined(__linux__)
+        return fdatasync(fd_) == 0;
+#else
+        return fsync(fd_) == 0;
+#endif
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (handle_ != INVALID_HANDLE_VALUE) CloseHandle(handle_);
+        handle_ = INVALID_HANDLE_VALUE;
+#else
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+#endif
+    }
+
+    /**
+     * @brief Make creates, renames and deletes in the directory holding
+     * `path` durable. No-op where directories cannot be synced.
+     */
+    static bool syncDirectory(const std::string& path) {
+#ifdef _WIN32
+        (void)path;
+        return true;
+#else
+        std::string dir = std::filesystem::path(path).parent_path().string();
+        int fd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        bool ok = fsync(fd) == 0;
+        ::close(fd);
+        return ok;
+#endif
+    }
+
+private:
+#ifdef _WIN32
+    HANDLE handle_ = INVALID_HANDLE_VALUE;
+#else
+    int fd_ = -1;
+#endif
+};
+
+/**
+ * @brief Write-ahead op log: durable autosave at a cost proportional to the edit.
+ *
+ * Ops are appended to `<base>.wal.<N>` as checksummed, VLE-packed frames
+ * and made durable in groups: commit() writes everything recorded since the
+ * previous commit with one write and one fsync. checkpoint() folds the log
+ * into `<base>.snap` off the caller's thread: the caller serializes the
+ * document and switches to log N+1, then a worker writes the snapshot to a
+ * temporary file, syncs it, renames it into place and only then deletes the
+ * logs it covers. recover() loads the snapshot and replays the logs after
+ * it. Replay is idempotent, so a crash at any point loses at most the ops
+ * recorded since the last commit.
+ *
+ * Works with any BasicSequence element type. Local ops are picked up from
+ * the document by clock. Ops received from peers are recorded as they are
+ * applied. Record before collecting garbage:
+ * ops the collector has already dropped can no longer be logged.
+ *
+ * Usage:
+ * ```cpp
+ * Sequence doc(my_id);
+ * OpLog log("notes");
+ * log.recover(doc);                  // Also for a brand new document
+ *
+ * doc.applyDelta(ops);               // Remote ops: record what you apply
+ * log.recordInserts(ops);
+ *
+ * // Every few hundred milliseconds
+ * log.recordLocal(doc);
+ * log.commit();
+ * log.checkpointIfNeeded(doc);
+ * ```
+ */
+class OpLog {
+public:
+    struct Config {
+        bool sync = true;                      // fsync on commit and checkpoint
+        size_t max_pending_bytes = 1 << 20;    // Commit early once this much is buffered
+        uint64_t checkpoint_bytes = 8 << 20;   // Log size at which checkpointIfNeeded() fires
+    };
+
+    struct Stats {
+        uint64_t records = 0;          // Frames recorded
+        uint64_t commits = 0;          // Group commits (one write and one sync each)
+        uint64_t bytes_written = 0;    // Frame bytes written to logs
+        uint64_t checkpoints = 0;      // Snapshots written and installed
+        uint64_t replayed = 0;         // Frames applied by recover()
+        uint64_t discarded_bytes = 0;  // Torn or corrupt log bytes skipped by recover()
+    };
+
+    explicit OpLog(std::string base_path) : OpLog(std::move(base_path), Config()) {}
+
+    OpLog(std::string base_path, Config config)
+        : base_(std::move(base_path)), config_(config) {}
+
+    ~OpLog() {
+        waitForCheckpoint();
+        commit();
+    }
+
+    OpLog(const OpLog&) = delete;
+    OpLog& operator=(const OpLog&) = delete;
+
+    /**
+     * @brief Load the snapshot into `doc`, replay the logs and open the
+     * newest one for appending. Must be called before recording.
+     * @return false if the snapshot or a log header is unreadable
+     */
+    template <typename Document>
+    bool recover(Document& doc) {
+        waitForCheckpoint();
+        log_.close();
+        pending_.clear();
+        snapshot_gen_ = 0;
+
+        std::ifstream snapshot(snapshotPath(), std::ios::binary);
+        if (snapshot) {
+            snapshot.read((char*)&snapshot_gen_, sizeof(snapshot_gen_));
+            if (!snapshot || !doc.load(snapshot)) return false;
+        }
+
+        // Logs a finished checkpoint did not get to delete
+        std::error_code ec;
+        for (uint64_t gen = snapshot_gen_; gen > 0 && std::filesystem::remove(logPath(gen - 1), ec); gen--) {}
+
+        uint64_t gen = snapshot_gen_;
+        while (std::filesystem::exists(logPath(gen))) {
+            bool newest = !std::filesystem::exists(logPath(gen + 1));
+            if (!replayLog(doc, logPath(gen), newest)) return false;
+            if (newest) break;
+            gen++;
+        }
+
+        local_clock_ = doc.getClock();
+        return openLog(gen);
+    }
+
+    /**
+     * @brief Record the document's own ops made since the last call.
+     */
+    template <typename Document>
+    void recordLocal(const Document& doc) {
+        // Everything the peer-style cursor has seen, except our own recent ops
+        VectorClock seen;
+        for (const auto& [client_id, time] : doc.getVectorClock().getState()) {
+            if (client_id != doc.getClientId()) seen.update(client_id, time);
+        }
+        seen.update(doc.getClientId(), local_clock_);
+        local_clock_ = doc.getClock();
+
+        auto inserts = doc.getDelta(seen);
+        // Deletes travel as their own records below
+        for (auto& atom : inserts) atom.is_deleted = false;
+        recordInserts(inserts);
+        recordDeleteOps(doc.getDeleteDelta(seen));
+    }
+
+    /**
+     * @brief Record inserts applied with remoteMerge() or applyDelta().
+     */
+    template <typename T>
+    void recordInserts(const std::vector<BasicAtom<T>>& ops) {
+        if (!ops.empty()) addFrame(kInserts, network::VLEPacker::packAtoms(ops));
+    }
+
+    /**
+     * @brief Record deletes applied with applyDeleteOps().
+     */
+    void recordDeleteOps(const std::vector<DeleteOp>& ops) {
+        if (!ops.empty()) addFrame(kDeleteOps, network::VLEPacker::packDeleteOps(ops));
+    }
+
+    /**
+     * @brief Record deletes applied with remoteDelete() or remoteDeleteRange().
+     */
+    void recordDeleteSpans(const std::vector<DeleteSpan>& spans) {
+        if (!spans.empty()) addFrame(kDeleteSpans, network::VLEPacker::packDeleteSpans(spans));
+    }
+
+    /**
+     * @brief Group commit: write all recorded frames with one write and one sync.
+     * @return false if the log is not open or the write failed
+     */
+    bool commit() {
+        if (!log_.isOpen()) return false;
+        if (pending_.empty()) return true;
+        if (!log_.append(pending_.data(), pending_.size())) return false;
+        if (config_.sync && !log_.sync()) return false;
+        log_bytes_ += pending_.size();
+        stats_.bytes_written += pending_.size();
+        stats_.commits++;
+        pending_.clear();
+        return true;
+    }
+
+    /**
+     * @brief Start folding the log into a fresh snapshot.
+     *
+     * Serializes `doc` on this thread and switches to a new log; writing
+     * the snapshot and dropping the old logs happens in the background.
+     * Waits for a checkpoint that is still running.
+     */
+    template <typename Document>
+    bool checkpoint(const Document& doc) {
+        waitForCheckpoint();  // A failed one leaves its logs for this one to fold
+        recordLocal(doc);
+        if (!commit()) return false;
+
+        uint64_t next_gen = gen_ + 1;
+        std::ostringstream out(std::ios::binary);
+        out.write((char*)&next_gen, sizeof(next_gen));
+        doc.save(out);
+
+        // Ops recorded from now on belong after the snapshot
+        if (!openLog(next_gen)) return false;
+
+        uint64_t first_gen = snapshot_gen_;
+        checkpoint_gen_ = next_gen;
+        checkpoint_ = std::async(std::launch::async, [this, data = out.str(), first_gen, next_gen] {
+            return installSnapshot(data) && removeLogs(first_gen, next_gen);
+        });
+        return true;
+    }
+
+    /**
+     * @brief checkpoint() once the current log reaches Config::checkpoint_bytes.
+     * Never blocks on a checkpoint that is still running.
+     */
+    template <typename Document>
+    bool checkpointIfNeeded(const Document& doc) {
+        if (checkpoint_.valid()) {
+            if (checkpoint_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+            waitForCheckpoint();
+        }
+        if (log_bytes_ + pending_.size() < config_.checkpoint_bytes) return false;
+        return checkpoint(doc);
+    }
+
+    /**
+     * @brief Wait for the running checkpoint, if any.
+     * @return false if it failed (its logs are kept and still replayed)
+     */
+    bool waitForCheckpoint() {
+        if (!checkpoint_.valid()) return true;
+        bool ok = checkpoint_.get();
+        if (ok) {
+            snapshot_gen_ = checkpoint_gen_;
+            stats_.checkpoints++;
+        }
+        return ok;
+    }
+
+    /**
+     * @brief Committed bytes in the current log.
+     */
+    uint64_t logBytes() const {
+        return log_bytes_;
+    }
+
+    const Stats& getStats() const {
+        return stats_;
+    }
+
+    std::string snapshotPath() const {
+        return base_ + ".snap";
+    }
+
+    std::string logPath(uint64_t gen) const {
+        return base_ + ".wal." + std::to_string(gen);
+    }
+
+private:
+    // Log file: [MAGIC: "OMNL"] [VER: 1b] then frames of
+    // [SIZE: 4b] [CRC32 of the rest: 4b] [TYPE: 1b] [PAYLOAD: SIZE - 1 bytes]
+    static constexpr uint8_t kVersion = 1;
+    static constexpr size_t kHeaderSize = 5;
+    static constexpr size_t kFrameHeaderSize = 8;
+    static constexpr uint8_t kInserts = 1;
+    static constexpr uint8_t kDeleteOps = 2;
+    static constexpr uint8_t kDeleteSpans = 3;
+
+    std::string base_;
+    Config config_;
+    Stats stats_;
+    DurableFile log_;
+    uint64_t gen_ = 0;           // Log being appended to
+    uint64_t snapshot_gen_ = 0;  // First log not folded into the snapshot
+    uint64_t log_bytes_ = 0;
+    uint64_t local_clock_ = 0;   // Own ops up to here are recorded
+    std::vector<uint8_t> pending_;
+    std::future<bool> checkpoint_;
+    uint64_t checkpoint_gen_ = 0;
+
+    static uint32_t crc32(const uint8_t* data, size_t size) {
+        static const std::array<uint32_t, 256> table = [] {
+            std::array<uint32_t, 256> t{};
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[i] = c;
+            }
+            return t;
+        }();
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    static void putU32(std::vector<uint8_t>& out, size_t at, uint32_t value) {
+        for (int i = 0; i < 4; i++) out[at + i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+
+    static uint32_t getU32(const uint8_t* in) {
+        return uint32_t(in[0]) | uint32_t(in[1]) << 8 | uint32_t(in[2]) << 16 | uint32_t(in[3]) << 24;
+    }
+
+    void addFrame(uint8_t type, const std::vector<uint8_t>& payload) {
+        size_t at = pending_.size();
+        pending_.resize(at + kFrameHeaderSize);
+        pending_.push_back(type);
+        pending_.insert(pending_.end(), payload.begin(), payload.end());
+        putU32(pending_, at, static_cast<uint32_t>(payload.size() + 1));
+        putU32(pending_, at + 4, crc32(pending_.data() + at + kFrameHeaderSize, payload.size() + 1));
+        stats_.records++;
+        if (pending_.size() >= config_.max_pending_bytes) commit();
+    }
+
+    bool openLog(uint64_t gen) {
+        log_.close();
+        std::string path = logPath(gen);
+        std::error_code ec;
+        uint64_t size = std::filesystem::exists(path) ? std::filesystem::file_size(path, ec) : 0;
+        if (ec || !log_.open(path)) return false;
+        gen_ = gen;
+        log_bytes_ = size;
+        if (size > 0) return true;
+
+        const uint8_t header[kHeaderSize] = {'O', 'M', 'N', 'L', kVersion};
+        if (!log_.append(header, kHeaderSize)) return false;
+        log_bytes_ = kHeaderSize;
+        return !config_.sync || (log_.sync() && DurableFile::syncDirectory(path));
+    }
+
+    /**
+     * @brief Apply every intact frame of one log. A torn tail on the newest
+     * log is cut off so new frames follow the last good one.
+     */
+    template <typename Document>
+    bool replayLog(Document& doc, const std::string& path, bool newest) {
+        std::ifstream in(path, std::ios::binary);
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        size_t pos = kHeaderSize;
+        if (data.size() < kHeaderSize) {
+            pos = 0;  // Crashed while creating it
+        } else if (std::memcmp(data.data(), "OMNL", 4) != 0 || data[4] != kVersion) {
+            return false;
+        }
+
+        std::vector<uint8_t> payload;
+        std::vector<typename Document::Atom> atoms;
+        std::vector<DeleteOp> ops;
+        std::vector<DeleteSpan> spans;
+        while (pos > 0 && data.size() - pos >= kFrameHeaderSize) {
+            uint32_t size = getU32(&data[pos]);
+            const uint8_t* frame = &data[pos + kFrameHeaderSize];
+            if (size == 0 || size > data.size() - pos - kFrameHeaderSize) break;
+            if (crc32(frame, size) != getU32(&data[pos + 4])) break;
+
+            payload.assign(frame + 1, frame + size);
+            if (frame[0] == kInserts && network::VLEPacker::unpackAtoms(payload, atoms)) {
+                doc.applyDelta(atoms);
+            } else if (frame[0] == kDeleteOps && network::VLEPacker::unpackDeleteOps(payload, ops)) {
+                doc.applyDeleteOps(ops);
+            } else if (frame[0] == kDeleteSpans && network::VLEPacker::unpackDeleteSpans(payload, spans)) {
+                doc.remoteDeleteRange(spans);
+            } else {
+                break;
+            }
+            stats_.replayed++;
+            pos += kFrameHeaderSize + size;
+        }
+
+        stats_.discarded_bytes += data.size() - pos;
+        if (newest && pos < data.size()) {
+            std::error_code ec;
+            std::filesystem::resize_file(path, pos, ec);
+            if (ec) return false;
+        }
+        return true;
+    }
+
+    // Runs on the checkpoint thread; touches only files, never the log being appended
+    bool installSnapshot(const std::string& data) const {
+        std::string path = snapshotPath();
+        std::string temp = path + ".tmp";
+        std::error_code ec;
+        std::filesystem::remove(temp, ec);
+
+        DurableFile file;
+        if (!file.open(temp)) return false;
+        if (!file.append((const uint8_t*)data.data(), data.size())) return false;
+        if (config_.sync && !file.sync()) return false;
+        file.close();
+
+        std::filesystem::rename(temp, path, ec);
+        if (ec) return false;
+        return !config_.sync || DurableFile::syncDirectory(path);
+    }
+
+    bool removeLogs(uint64_t first_gen, uint64_t end_gen) const {
+        std::error_code ec;
+        for (uint64_t gen = first_gen; gen < end_gen; gen++) {
+            std::filesystem::remove(logPath(gen), ec);
+        }
+        return true;
+    }
+};
+
+} // namespace omnisync::core
+
+#endif // OMNISYNC_CORE_OP_LOG_HPP
@@ -1,47 +1,346 @@
 #pragma once
 
-#include <list>
-#include <unordered_map>
-#include <unordered_set>
 #include <vector>
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <cstring> 
 #include <chrono>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <map>
+#include <mutex>
+#include <set>
+#include <bitset>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include "crdt_atom.hpp"
 #include "lamport_clock.hpp"
+#include "sequence_policy.hpp"
 #include "vector_clock.hpp"
 #include "memory_stats.hpp"
+#include "slab_pool.hpp"
+#include "flat_hash_map.hpp"
+#include "snapshot_view.hpp"
+#include "content_codec.hpp"
+#include "../network/vle_encoding.hpp"
 
 namespace omnisync {
 namespace core {
 
-struct AVLNode {
-    OpID id;
-    std::list<Atom>::iterator atom_it;
-    size_t weight;          // 1 if active, 0 if deleted/sentinel
+template <typename T>
+struct BasicAVLNode;
+
+/**
+ * @brief Run of consecutive inserts by one client (run-length encoded atoms).
+ *
+ * Atom j of the run has id {client_id, start_clock + j * step}. The first
+ * atom's origin is stored explicitly; every later atom's origin is the atom
+ * right before it in the run. Typing "hello" produces one run instead of
+ * five full atoms. A run splits when a remote insert lands inside it or
+ * when garbage collection removes one of its middle atoms.
+ *
+ * A local insert advances the Lamport clock twice (tick, then merge), so
+ * typed runs have step 2. Runs of one client never overlap in clock
+ * space, so they can be indexed by their start clock: a step-2 join is
+ * refused when the skipped clock is already taken, and a run is split
+ * when an atom with a skipped clock arrives later.
+ */
+struct AtomRun {
+    static constexpr uint64_t kMaxStep = 2;
+
+    uint64_t client_id;
+    uint64_t start_clock;
+    OpID origin;
+    uint32_t length;
+    uint32_t step;
+
+    OpID idAt(size_t j) const {
+        return {client_id, start_clock + j * step};
+    }
+
+    OpID originAt(size_t j) const {
+        return j == 0 ? origin : idAt(j - 1);
+    }
+
+    bool contains(const OpID& id) const {
+        if (id.client_id != client_id || id.clock < start_clock) return false;
+        uint64_t distance = id.clock - start_clock;
+        return distance % step == 0 && distance / step < length;
+    }
+
+    /**
+     * @brief Clock gap to `next_id` if it can extend this run, else 0.
+     */
+    uint64_t gapTo(const OpID& next_id, const OpID& next_origin) const {
+        OpID last = idAt(length - 1);
+        if (next_id.client_id != client_id || next_origin != last || next_id.clock <= last.clock) return 0;
+        uint64_t gap = next_id.clock - last.clock;
+        if (length > 1 ? gap != step : gap > kMaxStep) return 0;
+        return gap;
+    }
+
+    bool absorbs(const AtomRun& next) const {
+        uint64_t gap = gapTo(next.idAt(0), next.origin);
+        return gap != 0 && (next.length == 1 || next.step == gap);
+    }
+
+    void append(const AtomRun& next) {
+        step = static_cast<uint32_t>(gapTo(next.idAt(0), next.origin));
+        length += next.length;
+    }
+};
+
+/**
+ * @brief Leaf block of the rope: a contiguous slice of the document.
+ *
+ * Content and tombstone flags are stored as flat per-atom arrays in
+ * document order; ids and origins are stored as runs. Blocks are chained
+ * in document order, so full scans walk flat arrays instead of chasing
+ * one heap node per character. Blocks split when an insert lands in a
+ * full block and merge back when deletions leave them sparse.
+ *
+ * The start sentinel is always the first atom of the head block.
+ */
+template <typename T>
+struct BasicAtomChunk {
+    static constexpr size_t kCapacity = 128;  // Atoms per chunk
+    static constexpr size_t kMaxRuns = 32;    // Runs per chunk
+
+    T content[kCapacity];
+    std::bitset<kCapacity> deleted;
+    AtomRun runs[kMaxRuns];
+    size_t size = 0;
+    size_t run_count = 0;
+    BasicAtomChunk* prev = nullptr;
+    BasicAtomChunk* next = nullptr;
+    BasicAVLNode<T>* node = nullptr;    // Index node that owns this chunk
+    uint64_t stamp = 0;                 // Document edit count at the last change
+
+    bool isSentinel(size_t offset) const {
+        return !prev && offset == 0;
+    }
+
+    bool visible(size_t offset) const {
+        return !deleted[offset] && !isSentinel(offset);
+    }
+
+    /**
+     * @brief Number of visible atoms in [from, to).
+     */
+    size_t visibleCount(size_t from, size_t to) const {
+        if (from >= to) return 0;
+        std::bitset<kCapacity> mask;
+        mask.set();
+        mask >>= kCapacity - (to - from);
+        mask <<= from;
+        size_t count = (~deleted & mask).count();
+        if (from == 0 && !prev && !deleted[0]) count--;
+        return count;
+    }
+
+    /**
+     * @brief Index of the run holding atom `offset`; sets its first offset.
+     */
+    size_t runAt(size_t offset, size_t& run_offset) const {
+        size_t start = 0;
+        for (size_t r = 0; r < run_count; r++) {
+            if (offset < start + runs[r].length) {
+                run_offset = start;
+                return r;
+            }
+            start += runs[r].length;
+        }
+        run_offset = start;
+        return run_count;
+    }
+
+    OpID idAt(size_t offset) const {
+        size_t run_offset;
+        size_t r = runAt(offset, run_offset);
+        return runs[r].idAt(offset - run_offset);
+    }
+
+    BasicAtom<T> atomAt(size_t offset) const {
+        size_t run_offset;
+        size_t r = runAt(offset, run_offset);
+        BasicAtom<T> atom(runs[r].idAt(offset - run_offset), runs[r].originAt(offset - run_offset), content[offset]);
+        atom.is_deleted = deleted[offset];
+        return atom;
+    }
+
+    /**
+     * @brief Index of the run starting at `head`; sets its first offset.
+     */
+    size_t findRun(const OpID& head, size_t& run_offset) const {
+        size_t start = 0;
+        for (size_t r = 0; r < run_count; r++) {
+            if (runs[r].client_id == head.client_id && runs[r].start_clock == head.clock) {
+                run_offset = start;
+                return r;
+            }
+            start += runs[r].length;
+        }
+        run_offset = start;
+        return run_count;
+    }
+
+    size_t find(const OpID& id) const {
+        size_t start = 0;
+        for (size_t r = 0; r < run_count; r++) {
+            if (runs[r].contains(id)) return start + (id.clock - runs[r].start_clock) / runs[r].step;
+            start += runs[r].length;
+        }
+        return size;
+    }
+
+    /**
+     * @brief Smallest origin clock of any atom in the chunk.
+     */
+    uint64_t minOriginClock() const {
+        uint64_t result = std::numeric_limits<uint64_t>::max();
+        for (size_t r = 0; r < run_count; r++) {
+            result = std::min(result, runs[r].origin.clock);
+            if (runs[r].length > 1) result = std::min(result, runs[r].start_clock);
+        }
+        return result;
+    }
+
+    /**
+     * @brief First offset at or after `from` whose origin clock is below
+     * `clock`, or size if there is none.
+     * Past its head, a run's atoms point at their predecessor, so their
+     * origin clocks rise with the offset and each run is checked in O(1).
+     */
+    size_t findOlderOrigin(size_t from, uint64_t clock) const {
+        size_t start = 0;
+        for (size_t r = 0; r < run_count; r++) {
+            const AtomRun& run = runs[r];
+            if (from < start + run.length) {
+                size_t j = from > start ? from - start : 0;
+                if (j == 0) {
+                    if (run.origin.clock < clock) return start;
+                    j = 1;
+                }
+                if (j < run.length && run.start_clock + (j - 1) * run.step < clock) return start + j;
+            }
+            start += run.length;
+        }
+        return size;
+    }
+
+    /**
+     * @brief Open a gap at `offset` in the per-atom arrays.
+     */
+    void insertSlot(size_t offset, const T& c, bool is_deleted) {
+        std::copy_backward(content + offset, content + size, content + size + 1);
+        content[offset] = c;
+        std::bitset<kCapacity> low = deleted;
+        low <<= kCapacity - offset;
+        low >>= kCapacity - offset;
+        deleted = ((deleted >> offset) << (offset + 1)) | low;
+        deleted[offset] = is_deleted;
+        size++;
+    }
+
+    /**
+     * @brief Open `count` live slots at `offset`; content is left for the caller.
+     */
+    void openSlots(size_t offset, size_t count) {
+        std::copy_backward(content + offset, content + size, content + size + count);
+        std::bitset<kCapacity> low = deleted;
+        low <<= kCapacity - offset;
+        low >>= kCapacity - offset;
+        deleted = ((deleted >> offset) << (offset + count)) | low;
+        size += count;
+    }
+
+    /**
+     * @brief Close the slot at `offset` in the per-atom arrays.
+     */
+    void eraseSlot(size_t offset) {
+        std::copy(content + offset + 1, content + size, content + offset);
+        std::bitset<kCapacity> low = deleted;
+        low <<= kCapacity - offset;
+        low >>= kCapacity - offset;
+        deleted = ((deleted >> (offset + 1)) << offset) | low;
+        size--;
+    }
+
+    void insertRun(size_t r, const AtomRun& run) {
+        std::copy_backward(runs + r, runs + run_count, runs + run_count + 1);
+        runs[r] = run;
+        run_count++;
+    }
+
+    void eraseRun(size_t r) {
+        std::copy(runs + r + 1, runs + run_count, runs + r);
+        run_count--;
+    }
+};
+
+template <typename T>
+struct BasicAVLNode {
+    BasicAtomChunk<T>* chunk;
+    size_t weight;          // Visible atoms in the chunk
     size_t subtree_weight;  // Sum of weights in subtree
+    uint64_t min_origin;          // Lowest origin clock in the chunk
+    uint64_t subtree_min_origin;  // Lowest origin clock in the subtree
     int height;
-    AVLNode* left;
-    AVLNode* right;
-    AVLNode* parent;
-
-    AVLNode(OpID id_, std::list<Atom>::iterator it_, size_t w)
-        : id(id_), atom_it(it_), weight(w), subtree_weight(w), height(1),
+    bool dirty;             // subtree_weight awaits a batched refresh
+    BasicAVLNode* left;
+    BasicAVLNode* right;
+    BasicAVLNode* parent;
+
+    BasicAVLNode(BasicAtomChunk<T>* chunk_, size_t w)
+        : chunk(chunk_), weight(w), subtree_weight(w),
+          min_origin(std::numeric_limits<uint64_t>::max()),
+          subtree_min_origin(std::numeric_limits<uint64_t>::max()), height(1), dirty(false),
           left(nullptr), right(nullptr), parent(nullptr) {}
 };
 
+template <typename T>
+class DocumentVersion;
+
 /**
  * @brief The RGA Sequence Container (Production Ready).
  * Features:
  * - O(1) Local/Remote Insert (via Hash Map)
+ * - Chunked Rope Storage (contiguous atom blocks indexed by an AVL tree)
  * - Orphan Buffering (handles out-of-order parents)
  * - Delete Buffering (handles out-of-order deletes)
  * - Unified Merge Logic (Local == Remote)
  * - Binary Serialization (Save/Load)
  * - Delta Sync (90% bandwidth reduction)
+ * - Pooled Storage (chunks and index nodes come from per-document slabs)
+ *
+ * @tparam T Element type. `char` is text and gets the string API, the
+ *           cached text view and every snapshot format; other trivially
+ *           copyable types (char32_t code points, small structs, handles)
+ *           get the same CRDT, index, delta and GC paths, with values
+ *           serialized by ContentCodec.
+ * @tparam Allocator Allocator backing the chunk and index-node slabs.
+ * @tparam Policy Compile-time features (see DefaultSequencePolicy). Replicas
+ *         fed in causal order by one thread can drop the orphan and delete
+ *         buffers, auto-GC checks, GC timing and the atomic clock.
  */
-class Sequence {
+template <typename T = char, typename Allocator = std::allocator<char>, typename Policy = DefaultSequencePolicy>
+class BasicSequence {
+    template <typename>
+    friend class DocumentVersion;
+
+public:
+    using value_type = T;
+    using Atom = BasicAtom<T>;
+    using policy_type = Policy;
+
+private:
+    using AtomChunk = BasicAtomChunk<T>;
+    using AVLNode = BasicAVLNode<T>;
+    static constexpr bool kIsText = std::is_same_v<T, char>;
+
 public:
     /**
      * @brief Configuration for garbage collection behavior.
@@ -50,6 +349,8 @@ public:
         bool auto_gc_enabled = false;      // Enable automatic GC
         size_t tombstone_threshold = 1000; // Auto-GC trigger point
         uint64_t min_age_threshold = 100;  // Keep recent operations (safety margin)
+        size_t max_items_per_step = 0;     // Auto-GC removals per edit (0 = all)
+        uint64_t max_pause_us = 0;         // Auto-GC time per edit (0 = unbounded)
     };
     
     /**
@@ -57,40 +358,100 @@ public:
      */
     struct OrphanConfig {
         size_t max_orphan_buffer_size = 10000; // Total orphans across all buffers
-        uint64_t max_orphan_age = 1000;        // Clock difference threshold
+        // Local clock ticks (edits and received ops) an orphan may wait
+        uint64_t max_orphan_age = 1000;
     };
 
 private:
+    /**
+     * @brief Location of an atom inside the rope.
+     */
+    struct AtomPos {
+        AtomChunk* chunk;
+        size_t offset;
+    };
+
+    /**
+     * @brief An atom waiting for its origin, and its key in orphan_queue.
+     */
+    struct PendingOrphan {
+        Atom atom;
+        uint64_t seq;
+    };
+
+    struct OrphanEntry {
+        uint64_t buffered_at;  // Local clock when the atom arrived
+        OpID origin;
+    };
+
     uint64_t my_client_id;
-    LamportClock clock;
+    typename Policy::Clock clock;
     VectorClock vector_clock;  // Track causality for delta sync
     
-    // Primary Storage
-    std::list<Atom> atoms;
+    // Slab pools for chunks and index nodes (released in bulk)
+    SlabPool<AtomChunk, Allocator> chunk_pool;
+    SlabPool<AVLNode, Allocator> node_pool;
+
+    // Primary Storage (chunked rope, document order)
+    AtomChunk* head = nullptr;
+    AtomChunk* tail = nullptr;
+    size_t atom_count = 0;
+    size_t chunk_count = 0;
+    uint64_t edit_stamp = 0;  // Chunk and delete-log edits so far, see touch()
     
-    // Optimization Index
-    std::unordered_map<OpID, AVLNode*> atom_index;
-
-    // AVL Tree Root
+    // Optimization Index (client -> run start clock -> chunk holding the run)
+    FlatHashMap<uint64_t, std::map<uint64_t, AtomChunk*>> run_index;
+    size_t run_count = 0;
+    // Locality hint for locate(). Atomic so concurrent const reads, which
+    // all update it, don't race; any chunk it points to is valid.
+    mutable std::atomic<AtomChunk*> last_chunk{nullptr};
+
+    // Child Index (origin -> ids of run heads inserted after it, sorted).
+    // Atoms inside a run are the implicit child of their predecessor.
+    FlatHashMap<OpID, std::vector<OpID>> child_index;
+
+    // AVL Tree Root (one node per chunk, weighted by visible atoms)
     AVLNode* root = nullptr;
 
-    // Phase 0: Orphan Buffer
-    std::unordered_map<OpID, std::vector<Atom>> pending_orphans;
+    // Phase 0: Orphan Buffer (missing origin -> atoms waiting for it, in arrival order)
+    FlatHashMap<OpID, std::vector<PendingOrphan>> pending_orphans;
+    // Every buffered orphan by arrival number, so the oldest is first
+    std::map<uint64_t, OrphanEntry> orphan_queue;
+    uint64_t orphan_seq = 0;
     
     // Phase 0.5: Delete Buffer
-    std::unordered_set<OpID> pending_deletes;
+    FlatHashSet<OpID> pending_deletes;
+
+    // Delete Log (client -> delete-op records, sorted by clock and disjoint)
+    FlatHashMap<uint64_t, std::vector<DeleteOp>> delete_log;
+    FlatHashMap<uint64_t, uint64_t> delete_log_stamps;  // client -> edit stamp at its log's last change
     
     // Garbage Collection State
     GCConfig gc_config;
     size_t tombstone_count = 0;
+    FlatHashMap<uint64_t, std::set<uint64_t>> tombstone_index;  // client -> clocks of tombstones
+    bool applying_batch = false;  // Inside applyDelta: auto-GC waits for the end
     
     // Orphan Buffer State
     OrphanConfig orphan_config;
     size_t total_orphan_count = 0;
+    MemoryStats::OrphanStats orphan_stats_;
     
     // GC Performance Tracking
     MemoryStats::GCStats gc_stats_;
 
+    // Materialized text view: rebuilt on demand, then patched by small edits
+    struct TextPatch {
+        size_t index;
+        size_t erase;
+        std::string insert;
+    };
+    static constexpr size_t kMaxTextPatches = 64;
+    mutable std::mutex text_mutex;  // text() builds the cache from const reads
+    mutable std::string text_cache;
+    mutable std::vector<TextPatch> text_patches;
+    mutable bool text_cache_valid = false;
+
     // AVL Tree Helper Methods
     int getHeight(AVLNode* n) const {
         return n ? n->height : 0;
@@ -100,12 +461,20 @@ private:
         return n ? getHeight(n->left) - getHeight(n->right) : 0;
     }
 
+    uint64_t subtreeOriginBound(const AVLNode* n) const {
+        uint64_t bound = n->min_origin;
+        if (n->left) bound = std::min(bound, n->left->subtree_min_origin);
+        if (n->right) bound = std::min(bound, n->right->subtree_min_origin);
+        return bound;
+    }
+
     void updateHeightAndWeight(AVLNode* n) {
         if (!n) return;
         n->height = 1 + std::max(getHeight(n->left), getHeight(n->right));
         n->subtree_weight = n->weight + 
                             (n->left ? n->left->subtree_weight : 0) + 
                             (n->right ? n->right->subtree_weight : 0);
+        n->subtree_min_origin = subtreeOriginBound(n);
     }
 
     void rotateRight(AVLNode* y) {
@@ -212,12 +581,12 @@ private:
             AVLNode* s = z->right;
             while (s->left) s = s->left;
 
-            std::swap(z->id, s->id);
-            std::swap(z->atom_it, s->atom_it);
+            std::swap(z->chunk, s->chunk);
             std::swap(z->weight, s->weight);
+            std::swap(z->min_origin, s->min_origin);
 
-            atom_index[z->id] = z;
-            atom_index[s->id] = s;
+            z->chunk->node = z;
+            s->chunk->node = s;
 
             z = s;
         }
@@ -236,7 +605,7 @@ private:
             root = child;
         }
 
-        delete z;
+        node_pool.destroy(z);
 
         AVLNode* curr = parent;
         while (curr) {
@@ -256,249 +625,1630 @@ private:
         }
     }
 
-    void destroyTree(AVLNode* node) {
-        if (!node) return;
-        destroyTree(node->left);
-        destroyTree(node->right);
-        delete node;
+    /**
+     * @brief Recompute a chunk's lowest origin clock and fix the subtree
+     * bounds above it (after atoms left the chunk).
+     */
+    void refreshOriginBound(AtomChunk* chunk) {
+        AVLNode* node = chunk->node;
+        node->min_origin = chunk->minOriginClock();
+        for (; node; node = node->parent) {
+            uint64_t bound = subtreeOriginBound(node);
+            if (bound == node->subtree_min_origin) break;
+            node->subtree_min_origin = bound;
+        }
     }
 
-    AVLNode* findNodeByPrefixWeight(AVLNode* node, size_t target_weight) const {
-        if (!node) return nullptr;
-        if (target_weight == 0) {
-            AVLNode* curr = node;
-            while (curr->left) curr = curr->left;
-            return curr;
+    /**
+     * @brief Account for an atom with `origin_clock` added to `chunk`.
+     */
+    void lowerOriginBound(AtomChunk* chunk, uint64_t origin_clock) {
+        AVLNode* node = chunk->node;
+        node->min_origin = std::min(node->min_origin, origin_clock);
+        for (; node && node->subtree_min_origin > origin_clock; node = node->parent) {
+            node->subtree_min_origin = origin_clock;
         }
+    }
 
-        AVLNode* curr = node;
+    /**
+     * @brief Set a node's weight without touching its ancestors yet.
+     * Ancestors are queued once each; call refreshWeights() when done.
+     */
+    void setWeightDeferred(AVLNode* node, size_t new_weight, std::vector<AVLNode*>& dirty) {
+        node->weight = new_weight;
+        for (AVLNode* n = node; n && !n->dirty; n = n->parent) {
+            n->dirty = true;
+            dirty.push_back(n);
+        }
+    }
+
+    /**
+     * @brief Recompute subtree weights of queued nodes in one bottom-up pass.
+     * A child is always lower than its parent, so sorting by height orders
+     * every node after its queued descendants.
+     */
+    void refreshWeights(std::vector<AVLNode*>& dirty) {
+        std::sort(dirty.begin(), dirty.end(),
+                  [](const AVLNode* a, const AVLNode* b) { return a->height < b->height; });
+        for (AVLNode* n : dirty) {
+            n->subtree_weight = n->weight +
+                                (n->left ? n->left->subtree_weight : 0) +
+                                (n->right ? n->right->subtree_weight : 0);
+            n->dirty = false;
+        }
+        dirty.clear();
+    }
+
+    /**
+     * @brief Find the atom holding the target-th visible position.
+     * Position 0 is the start sentinel; positions past the end resolve to
+     * the last atom in the document.
+     */
+    AtomPos findByPrefixWeight(size_t target_weight) const {
+        if (!root || head->size == 0) return {nullptr, 0};
+        if (target_weight == 0) return {head, 0};
+
+        AVLNode* curr = root;
         size_t remaining = target_weight;
-        while (curr) {
+        while (true) {
             size_t left_weight = curr->left ? curr->left->subtree_weight : 0;
             if (remaining <= left_weight) {
-                if (!curr->left) return curr;
                 curr = curr->left;
             } else if (remaining <= left_weight + curr->weight) {
-                return curr;
+                remaining -= left_weight;
+                break;
             } else {
                 remaining -= (left_weight + curr->weight);
-                if (!curr->right) return curr;
+                if (!curr->right) return {tail, tail->size - 1};
                 curr = curr->right;
             }
         }
-        return nullptr;
+
+        AtomChunk* chunk = curr->chunk;
+        for (size_t i = 0; i < chunk->size; i++) {
+            if (chunk->visible(i) && --remaining == 0) return {chunk, i};
+        }
+        return {chunk, chunk->size - 1};
     }
 
-public:
-    Sequence(uint64_t client_id) : my_client_id(client_id), vector_clock(client_id) {
-        OpID start_id = {0, 0};
-        atoms.emplace_back(start_id, start_id, '\0');
-        root = new AVLNode(start_id, atoms.begin(), 0);
-        atom_index[start_id] = root;
+    // Run Index Helper Methods
+    void indexRun(const AtomRun& run, AtomChunk* chunk) {
+        auto& runs = run_index[run.client_id];
+        auto result = runs.insert({run.start_clock, chunk});
+        if (result.second) {
+            run_count++;
+            addChild(run.origin, run.idAt(0));
+        } else {
+            result.first->second = chunk;
+        }
     }
 
-    ~Sequence() {
-        destroyTree(root);
+    void unindexRun(const AtomRun& run) {
+        auto client_it = run_index.find(run.client_id);
+        if (client_it == run_index.end()) return;
+        if (client_it->second.erase(run.start_clock)) {
+            run_count--;
+            removeChild(run.origin, run.idAt(0));
+        }
+        if (client_it->second.empty()) run_index.erase(client_it);
     }
 
-    Sequence(const Sequence&) = delete;
-    Sequence& operator=(const Sequence&) = delete;
+    void addChild(const OpID& origin, const OpID& child) {
+        std::vector<OpID>& children = child_index[origin];
+        children.insert(std::upper_bound(children.begin(), children.end(), child), child);
+    }
 
-    Sequence(Sequence&& other) noexcept 
-        : my_client_id(other.my_client_id),
-          clock(std::move(other.clock)),
-          vector_clock(std::move(other.vector_clock)),
-          atoms(std::move(other.atoms)),
-          atom_index(std::move(other.atom_index)),
-          pending_orphans(std::move(other.pending_orphans)),
-          pending_deletes(std::move(other.pending_deletes)),
-          gc_config(other.gc_config),
-          tombstone_count(other.tombstone_count),
-          orphan_config(other.orphan_config),
-          total_orphan_count(other.total_orphan_count),
-          gc_stats_(other.gc_stats_),
-          root(other.root) {
-        other.root = nullptr;
+    void removeChild(const OpID& origin, const OpID& child) {
+        auto it = child_index.find(origin);
+        if (it == child_index.end()) return;
+        std::vector<OpID>& children = it->second;
+        auto pos = std::lower_bound(children.begin(), children.end(), child);
+        if (pos != children.end() && *pos == child) children.erase(pos);
+        if (children.empty()) child_index.erase(it);
     }
 
-    Sequence& operator=(Sequence&& other) noexcept {
-        if (this != &other) {
-            destroyTree(root);
-            my_client_id = other.my_client_id;
-            clock = std::move(other.clock);
-            vector_clock = std::move(other.vector_clock);
-            atoms = std::move(other.atoms);
-            atom_index = std::move(other.atom_index);
-            pending_orphans = std::move(other.pending_orphans);
-            pending_deletes = std::move(other.pending_deletes);
-            gc_config = other.gc_config;
-            tombstone_count = other.tombstone_count;
-            orphan_config = other.orphan_config;
-            total_orphan_count = other.total_orphan_count;
-            gc_stats_ = other.gc_stats_;
-            root = other.root;
-            other.root = nullptr;
+    AtomChunk* findChunk(const OpID& id) const {
+        auto client_it = run_index.find(id.client_id);
+        if (client_it == run_index.end()) return nullptr;
+        const auto& runs = client_it->second;
+        auto it = runs.upper_bound(id.clock);
+        if (it == runs.begin()) return nullptr;
+        return std::prev(it)->second;
+    }
+
+    AtomPos locate(const OpID& id) const {
+        AtomChunk* hint = last_chunk.load(std::memory_order_relaxed);
+        if (hint) {
+            size_t offset = hint->find(id);
+            if (offset < hint->size) return {hint, offset};
         }
-        return *this;
+        AtomChunk* chunk = findChunk(id);
+        if (!chunk) return {nullptr, 0};
+        size_t offset = chunk->find(id);
+        if (offset == chunk->size) return {nullptr, 0};
+        last_chunk.store(chunk, std::memory_order_relaxed);
+        return {chunk, offset};
     }
 
-    Atom localInsert(size_t literal_index, char content) {
-        uint64_t tick = clock.tick();
-        vector_clock.tick(); // Update vector clock too
-        OpID new_id = { my_client_id, tick };
+    bool contains(const OpID& id) const {
+        return locate(id).chunk != nullptr;
+    }
 
-        AVLNode* parent_node = findNodeByPrefixWeight(root, literal_index);
-        OpID parent_id = parent_node ? parent_node->id : OpID{0, 0};
-        Atom new_atom(new_id, parent_id, content);
-        
-        // UNIFIED LOGIC: Treat local inserts exactly like remote ones.
-        remoteMerge(new_atom);
+    /**
+     * @brief Stamp a chunk as changed, so the next DocumentVersion copies
+     * it instead of sharing the previous copy.
+     */
+    void touch(AtomChunk* chunk) {
+        chunk->stamp = ++edit_stamp;
+    }
 
-        return new_atom;
+    /**
+     * @brief Merge run r+1 into run r when it continues it.
+     */
+    void coalesceRuns(AtomChunk* chunk, size_t r) {
+        if (r + 1 >= chunk->run_count) return;
+        AtomRun& left = chunk->runs[r];
+        const AtomRun& right = chunk->runs[r + 1];
+        if (!joins(left, right)) return;
+        unindexRun(right);
+        left.append(right);
+        chunk->eraseRun(r + 1);
     }
 
-    void remoteMerge(Atom new_atom) {
-        clock.merge(new_atom.id.clock);
-        vector_clock.update(new_atom.id.client_id, new_atom.id.clock);
-        
-        if (atom_index.count(new_atom.id)) return;
+    /**
+     * @brief Can `next` be appended to `run`? A step-2 join skips a clock,
+     * so it is refused if the client already has an atom there: the run
+     * index needs a client's runs to stay disjoint in clock space, and
+     * peers need not follow the local clock discipline.
+     */
+    bool joins(const AtomRun& run, const AtomRun& next) const {
+        if (!run.absorbs(next)) return false;
+        OpID last = run.idAt(run.length - 1);
+        return next.start_clock - last.clock == 1 || !contains({last.client_id, last.clock + 1});
+    }
 
-        auto parent_map_it = atom_index.find(new_atom.origin);
-        if (parent_map_it == atom_index.end()) {
-            // Orphan: parent doesn't exist yet
-            if (total_orphan_count >= orphan_config.max_orphan_buffer_size) {
-                evictOldOrphans();
-            }
-            pending_orphans[new_atom.origin].push_back(new_atom);
-            total_orphan_count++;
-            return;
-        }
+    /**
+     * @brief Runs an insert at `offset` would add (0 = extends a run).
+     */
+    size_t runsNeeded(const AtomChunk* chunk, size_t offset, const Atom& atom) const {
+        if (offset == 0) return 1;
+        size_t run_offset;
+        size_t r = chunk->runAt(offset - 1, run_offset);
+        const AtomRun& run = chunk->runs[r];
+        if (offset - run_offset < run.length) return 2; // splits run r
+        return joins(run, {atom.id.client_id, atom.id.clock, atom.origin, 1, 1}) ? 0 : 1;
+    }
 
-        AVLNode* parent_node = parent_map_it->second;
-        auto parent_it = parent_node->atom_it;
-        auto current_it = std::next(parent_it);
-        
-        while (current_it != atoms.end()) {
-            const Atom& c = *current_it;
-            if (c.origin.clock < new_atom.origin.clock) break;
+    bool hasRoom(const AtomChunk* chunk, size_t offset, const Atom& atom) {
+        return chunk->size < AtomChunk::kCapacity &&
+               chunk->run_count + runsNeeded(chunk, offset, atom) <= AtomChunk::kMaxRuns;
+    }
 
-            if (c.origin == new_atom.origin) {
-                if (new_atom.id < c.id) break; 
-            }
-            current_it++;
-        }
+    /**
+     * @brief Link a fresh, empty chunk into the rope right after `pos`.
+     */
+    AtomChunk* insertChunkAfter(AtomChunk* pos) {
+        AtomChunk* chunk = linkChunkAfter(pos);
+        insertNode(pos->node, chunk->node);
+        return chunk;
+    }
 
-        auto new_it = atoms.insert(current_it, new_atom);
-        
-        auto prev_it = std::prev(new_it);
-        AVLNode* prev_node = atom_index[prev_it->id];
+    /**
+     * @brief insertChunkAfter() without the index tree, for bulk loads.
+     */
+    AtomChunk* linkChunkAfter(AtomChunk* pos) {
+        AtomChunk* chunk = chunk_pool.create();
+        chunk->node = node_pool.create(chunk, 0);
+        chunk_count++;
+        touch(chunk);
+
+        chunk->prev = pos;
+        chunk->next = pos->next;
+        if (pos->next) pos->next->prev = chunk;
+        else tail = chunk;
+        pos->next = chunk;
+        return chunk;
+    }
 
-        size_t weight = new_atom.is_deleted ? 0 : 1;
-        if (new_atom.id.client_id == 0 && new_atom.id.clock == 0) weight = 0; // sentinel
-        
-        AVLNode* new_node = new AVLNode(new_atom.id, new_it, weight);
-        atom_index[new_atom.id] = new_node;
-        
-        insertNode(prev_node, new_node);
-        
-        if (pending_deletes.count(new_atom.id)) {
-            new_it->is_deleted = true;
-            tombstone_count++;
-            updateWeight(new_node, 0);
-            pending_deletes.erase(new_atom.id);
-        }
-        
-        checkPendingOrphans(new_atom.id);
-        
-        // Auto-GC check
-        if (gc_config.auto_gc_enabled && tombstone_count >= gc_config.tombstone_threshold) {
-            garbageCollectLocal(gc_config.min_age_threshold);
+    void removeChunk(AtomChunk* chunk) {
+        if (chunk->prev) chunk->prev->next = chunk->next;
+        else head = chunk->next;
+        if (chunk->next) chunk->next->prev = chunk->prev;
+        else tail = chunk->prev;
+        if (last_chunk.load(std::memory_order_relaxed) == chunk) {
+            last_chunk.store(nullptr, std::memory_order_relaxed);
         }
+
+        deleteNode(chunk->node);
+        chunk_pool.destroy(chunk);
+        chunk_count--;
     }
-    
-    OpID localDelete(size_t literal_index) {
-        clock.tick();
-        vector_clock.tick();
 
-        AVLNode* target_node = findNodeByPrefixWeight(root, literal_index + 1);
-        if (target_node && target_node->weight == 1) {
-            auto it = target_node->atom_it;
-            OpID deleted_id = it->id;
-            it->is_deleted = true;
-            tombstone_count++;
-            
-            updateWeight(target_node, 0);
-            
-            // Auto-GC check
-            if (gc_config.auto_gc_enabled && tombstone_count >= gc_config.tombstone_threshold) {
-                garbageCollectLocal(gc_config.min_age_threshold);
-            }
-            
-            return deleted_id;
+    /**
+     * @brief Move atoms [from, size) of `src` to the end of `dst`.
+     */
+    void moveAtoms(AtomChunk* src, size_t from, AtomChunk* dst) {
+        if (from >= src->size) return;
+        size_t moved_weight = src->visibleCount(from, src->size);
+        touch(src);
+        touch(dst);
+
+        for (size_t i = from; i < src->size; i++) {
+            dst->content[dst->size] = src->content[i];
+            dst->deleted[dst->size] = src->deleted[i];
+            dst->size++;
         }
-        return {0,0};
-    }
 
-    void remoteDelete(OpID target_id) {
-        auto map_it = atom_index.find(target_id);
-        if (map_it != atom_index.end()) {
-            AVLNode* node = map_it->second;
-            if (!node->atom_it->is_deleted) {
-                node->atom_it->is_deleted = true;
-                tombstone_count++;
-                updateWeight(node, 0);
-            }
-        } else {
-            pending_deletes.insert(target_id);
+        size_t run_offset;
+        size_t r = src->runAt(from, run_offset);
+        size_t seam = dst->run_count;
+        size_t keep = r;
+        if (from > run_offset) {
+            // Split the run straddling the cut
+            AtomRun& run = src->runs[r];
+            size_t k = from - run_offset;
+            AtomRun piece = {run.client_id, run.idAt(k).clock, run.idAt(k - 1),
+                             static_cast<uint32_t>(run.length - k), run.step};
+            run.length = static_cast<uint32_t>(k);
+            dst->runs[dst->run_count++] = piece;
+            indexRun(piece, dst);
+            keep = ++r;
+        }
+        for (; r < src->run_count; r++) {
+            dst->runs[dst->run_count++] = src->runs[r];
+            indexRun(src->runs[r], dst);
         }
+        src->run_count = keep;
+        for (size_t i = from; i < src->size; i++) src->deleted[i] = false;
+        src->size = from;
+        if (seam > 0) coalesceRuns(dst, seam - 1);
+
+        updateWeight(src->node, src->node->weight - moved_weight);
+        updateWeight(dst->node, dst->node->weight + moved_weight);
+        refreshOriginBound(src);
+        refreshOriginBound(dst);
     }
 
     /**
-     * @brief DELTA SYNC: Get operations that peer is missing.
-     * @param peer_state The vector clock representing what the peer has seen.
-     * @return Vector of atoms that are new to the peer.
-     * 
-     * Example:
-     *   My state: {A:5, B:3}
-     *   Peer state: {A:3, B:3}
-     *   Delta: All operations from A with clock > 3
+     * @brief Split `chunk` in half, returning the new right-hand chunk.
      */
-    std::vector<Atom> getDelta(const VectorClock& peer_state) const {
-        std::vector<Atom> delta;
-        
-        for (const auto& atom : atoms) {
-            // Skip the start node
-            if (atom.id.client_id == 0 && atom.id.clock == 0) continue;
-            
-            // Check if peer has seen this operation
-            uint64_t peer_time = peer_state.get(atom.id.client_id);
-            
-            if (atom.id.clock > peer_time) {
-                // Peer hasn't seen this operation
-                delta.push_back(atom);
-            }
-        }
-        
-        return delta;
+    AtomChunk* splitChunk(AtomChunk* chunk) {
+        AtomChunk* right = insertChunkAfter(chunk);
+        moveAtoms(chunk, chunk->size / 2, right);
+        return right;
     }
 
     /**
-     * @brief DELTA SYNC: Apply a delta from another peer.
-     * @param delta Vector of atoms received from peer.
-     * 
-     * This is more efficient than sending the entire document.
-     * Instead of sending 10,000 atoms, we might only send 5.
+     * @brief Split the run whose clock span skips over `id` (a step-2 run
+     * of the same client), so the client's runs stay disjoint once `id`
+     * is placed. `indexed` is false during bulk loads, before buildIndex().
      */
-    void applyDelta(const std::vector<Atom>& delta) {
-        for (const auto& atom : delta) {
-            if (atom.is_deleted) {
-                remoteDelete(atom.id);
-            } else {
-                remoteMerge(atom);
+    void splitSpanningRun(const OpID& id, bool indexed) {
+        while (true) {
+            AtomChunk* chunk = findChunk(id);
+            if (!chunk) return;
+            size_t r = 0;
+            for (; r < chunk->run_count; r++) {
+                const AtomRun& run = chunk->runs[r];
+                if (run.client_id == id.client_id && run.start_clock < id.clock &&
+                    id.clock < run.idAt(run.length - 1).clock) {
+                    break;
+                }
+            }
+            if (r == chunk->run_count || chunk->runs[r].contains(id)) return;
+
+            if (chunk->run_count < AtomChunk::kMaxRuns) {
+                AtomRun& run = chunk->runs[r];
+                size_t k = (id.clock - run.start_clock) / run.step + 1;
+                AtomRun piece = {run.client_id, run.idAt(k).clock, run.idAt(k - 1),
+                                 static_cast<uint32_t>(run.length - k), run.step};
+                run.length = static_cast<uint32_t>(k);
+                chunk->insertRun(r + 1, piece);
+                indexRun(piece, chunk);
+                touch(chunk);
+                return;
             }
+            // No free run slot: halve the chunk and look again
+            AtomChunk* right = indexed ? insertChunkAfter(chunk) : linkChunkAfter(chunk);
+            moveAtoms(chunk, chunk->size / 2, right);
         }
     }
 
+    /**
+     * @brief Write an atom into a chunk with room, extending or splitting runs.
+     */
+    void placeAtom(AtomChunk* chunk, size_t offset, const Atom& atom) {
+        AtomRun single = {atom.id.client_id, atom.id.clock, atom.origin, 1, 1};
+        touch(chunk);
+        size_t r = 0;
+        if (offset > 0) {
+            size_t run_offset;
+            r = chunk->runAt(offset - 1, run_offset);
+            AtomRun& run = chunk->runs[r];
+            size_t k = offset - run_offset;
+            if (k == run.length && joins(run, single)) {
+                chunk->insertSlot(offset, atom.content, atom.is_deleted);
+                run.append(single);
+                coalesceRuns(chunk, r);
+                return;
+            }
+            if (k < run.length) {
+                AtomRun piece = {run.client_id, run.idAt(k).clock, run.idAt(k - 1),
+                                 static_cast<uint32_t>(run.length - k), run.step};
+                run.length = static_cast<uint32_t>(k);
+                chunk->insertRun(r + 1, piece);
+                indexRun(piece, chunk);
+            }
+            r++;
+        }
+
+        chunk->insertSlot(offset, atom.content, atom.is_deleted);
+        chunk->insertRun(r, single);
+        indexRun(single, chunk);
+        coalesceRuns(chunk, r);
+    }
+
+    /**
+     * @brief RGA placement: find the insert slot right of the parent.
+     *
+     * The slot is before the first atom after the parent whose origin is
+     * older than the new atom's origin, or before a sibling with a larger
+     * id, whichever comes first. Siblings sit in ascending id order, so:
+     * - the first larger sibling is the parent's in-run successor or comes
+     *   from the child index, and
+     * - the first older-origin atom is found with the tree's min-origin
+     *   bounds.
+     * Both are O(log n) however many concurrent siblings there are.
+     */
+    AtomPos scanForInsert(AtomPos parent, const Atom& new_atom) const {
+        AtomChunk* chunk = parent.chunk;
+        AtomPos after = {chunk, parent.offset + 1};
+        size_t run_offset;
+        const AtomRun& run = chunk->runs[chunk->runAt(parent.offset, run_offset)];
+        if (after.offset - run_offset < run.length) {
+            // The in-run successor is the first, and smallest, sibling
+            if (new_atom.id < run.idAt(after.offset - run_offset)) return after;
+        }
+
+        AtomPos stop = findOlderOrigin(after, new_atom.origin.clock);
+        auto it = child_index.find(new_atom.origin);
+        if (it == child_index.end()) return stop;
+        const std::vector<OpID>& children = it->second;
+        for (auto sibling = std::upper_bound(children.begin(), children.end(), new_atom.id);
+             sibling != children.end(); ++sibling) {
+            // A parent re-sent after being collected lands after its old children
+            AtomPos pos = locate(*sibling);
+            if (precedes(parent, pos)) return precedes(pos, stop) ? pos : stop;
+        }
+        return stop;
+    }
+
+    /**
+     * @brief Does the slot at `a` come before the one at `b`? O(log n).
+     */
+    bool precedes(AtomPos a, AtomPos b) const {
+        if (a.chunk == b.chunk) return a.offset < b.offset;
+
+        // Root paths of both chunks; the first step where they part decides
+        const AVLNode* path_a[64];
+        const AVLNode* path_b[64];
+        size_t depth_a = 0, depth_b = 0;
+        for (const AVLNode* n = a.chunk->node; n; n = n->parent) path_a[depth_a++] = n;
+        for (const AVLNode* n = b.chunk->node; n; n = n->parent) path_b[depth_b++] = n;
+        while (depth_a > 0 && depth_b > 0 && path_a[depth_a - 1] == path_b[depth_b - 1]) {
+            depth_a--;
+            depth_b--;
+        }
+        const AVLNode* split = path_a[depth_a];  // Lowest common ancestor
+        if (depth_a == 0) return split->right == path_b[depth_b - 1];
+        return split->left == path_a[depth_a - 1];
+    }
+
+    /**
+     * @brief First atom at or after `from` whose origin clock is below
+     * `origin_clock`, or the end of the document.
+     */
+    AtomPos findOlderOrigin(AtomPos from, uint64_t origin_clock) const {
+        size_t offset = from.chunk->findOlderOrigin(from.offset, origin_clock);
+        if (offset < from.chunk->size) return {from.chunk, offset};
+
+        // Climb to the first later chunk, or subtree, that holds a match
+        const AVLNode* node = from.chunk->node;
+        const AVLNode* target = nullptr;
+        if (node->right && node->right->subtree_min_origin < origin_clock) {
+            target = node->right;
+        } else {
+            for (; node->parent; node = node->parent) {
+                const AVLNode* parent = node->parent;
+                if (parent->left != node) continue;
+                if (parent->min_origin < origin_clock) {
+                    return {parent->chunk, parent->chunk->findOlderOrigin(0, origin_clock)};
+                }
+                if (parent->right && parent->right->subtree_min_origin < origin_clock) {
+                    target = parent->right;
+                    break;
+                }
+            }
+        }
+        if (!target) return {tail, tail->size};
+
+        // Leftmost chunk of the subtree with a match
+        while (true) {
+            if (target->left && target->left->subtree_min_origin < origin_clock) {
+                target = target->left;
+            } else if (target->min_origin < origin_clock) {
+                break;
+            } else {
+                target = target->right;
+            }
+        }
+        return {target->chunk, target->chunk->findOlderOrigin(0, origin_clock)};
+    }
+
+    /**
+     * @brief Insert an atom so that it ends up at `pos` (before the atom
+     * currently there, or at the end of the chunk). Splits full chunks.
+     */
+    AtomPos insertAtom(AtomPos pos, const Atom& atom) {
+        AtomChunk* chunk = pos.chunk;
+        size_t offset = pos.offset;
+
+        while (!hasRoom(chunk, offset, atom)) {
+            if (offset == chunk->size) {
+                // Appending past a full chunk: spill into the next one
+                if (chunk->next && hasRoom(chunk->next, 0, atom)) {
+                    chunk = chunk->next;
+                } else {
+                    chunk = insertChunkAfter(chunk);
+                }
+                offset = 0;
+            } else if (offset == 0 && chunk->prev && hasRoom(chunk->prev, chunk->prev->size, atom)) {
+                chunk = chunk->prev;
+                offset = chunk->size;
+            } else {
+                // Halving may leave most runs on one side; repeat until it fits
+                AtomChunk* right = splitChunk(chunk);
+                if (offset > chunk->size) {
+                    offset -= chunk->size;
+                    chunk = right;
+                }
+            }
+        }
+
+        placeAtom(chunk, offset, atom);
+        lowerOriginBound(chunk, atom.origin.clock);
+        atom_count++;
+        last_chunk.store(chunk, std::memory_order_relaxed);
+        if (atom.is_deleted && !chunk->isSentinel(offset)) indexTombstone(atom.id);
+
+        if (chunk->visible(offset)) {
+            updateWeight(chunk->node, chunk->node->weight + 1);
+            if constexpr (kIsText) {
+                if (text_cache_valid) recordTextPatch(visibleIndex({chunk, offset}), 0, std::string_view(&chunk->content[offset], 1));
+            }
+        }
+        return {chunk, offset};
+    }
+
+    /**
+     * @brief Drop all content and bookkeeping ahead of a load.
+     */
+    void resetForLoad() {
+        destroyRope();
+        run_index.clear();
+        child_index.clear();
+        pending_orphans.clear();
+        orphan_queue.clear();
+        pending_deletes.clear();
+        delete_log.clear();
+        delete_log_stamps.clear();
+        tombstone_index.clear();
+        
+        initRope();
+        tombstone_count = 0;
+        total_orphan_count = 0;
+    }
+
+    /**
+     * @brief Append an atom to the last chunk without touching the index
+     * tree, for bulk loads. Call buildIndex() once all atoms are in.
+     */
+    void appendAtomUnindexed(const Atom& atom) {
+        splitSpanningRun(atom.id, false);
+        AtomChunk* chunk = tail;
+        if (!hasRoom(chunk, chunk->size, atom)) chunk = linkChunkAfter(tail);
+
+        size_t offset = chunk->size;
+        placeAtom(chunk, offset, atom);
+        atom_count++;
+        AVLNode* node = chunk->node;
+        node->min_origin = std::min(node->min_origin, atom.origin.clock);
+        if (chunk->visible(offset)) node->weight++;
+        if (atom.is_deleted && !chunk->isSentinel(offset)) indexTombstone(atom.id);
+    }
+
+    /**
+     * @brief Rebuild the index tree over the chunk list in O(chunks).
+     * Taking the middle chunk as root at every level yields a perfectly
+     * balanced (hence valid AVL) tree without any rotations.
+     */
+    void buildIndex() {
+        std::vector<AVLNode*> nodes;
+        nodes.reserve(chunk_count);
+        for (AtomChunk* chunk = head; chunk; chunk = chunk->next) nodes.push_back(chunk->node);
+        root = buildSubtree(nodes, 0, nodes.size(), nullptr);
+    }
+
+    /**
+     * @brief Encode atoms and the delete log as LEB128 columns (snapshot v3).
+     *
+     * Body: [ATOM_COUNT] [RUN_COUNT] [CLIENTS: count, ids]
+     *       [RUN CLIENT: dictionary index] [RUN CLOCK: zigzag delta to previous run]
+     *       [RUN LENGTH] [RUN STEP]
+     *       [RUN ORIGIN: 0 if it is the previous atom, else client index + 1 and
+     *        zigzag distance below the run's first clock]
+     *       [CONTENT: raw bytes] [DELETED: bitmap]
+     *       [DELETE LOG: clients, then per client: id, record count, records as
+     *        (gap after previous record, target client, target clock, step, length)]
+     *
+     * Runs continuing across chunk boundaries are written as one run.
+     */
+    void writeColumns(std::vector<uint8_t>& body) const {
+        using network::VLEEncoding;
+
+        std::vector<AtomRun> runs;
+        for (const AtomChunk* chunk = head; chunk; chunk = chunk->next) {
+            for (size_t r = 0; r < chunk->run_count; r++) {
+                const AtomRun& run = chunk->runs[r];
+                if (!runs.empty()) {
+                    AtomRun& last = runs.back();
+                    OpID last_id = last.idAt(last.length - 1);
+                    if (run.client_id == last.client_id && run.step == last.step &&
+                        run.start_clock == last_id.clock + last.step && run.origin == last_id &&
+                        (last.step == 1 || !contains({last_id.client_id, last_id.clock + 1}))) {
+                        last.length += run.length;
+                        continue;
+                    }
+                }
+                runs.push_back(run);
+            }
+        }
+
+        FlatHashMap<uint64_t, uint64_t> client_slot;
+        std::vector<uint64_t> clients;
+        auto slot = [&](uint64_t client_id) {
+            auto it = client_slot.find(client_id);
+            if (it != client_slot.end()) return it->second;
+            client_slot[client_id] = clients.size();
+            clients.push_back(client_id);
+            return static_cast<uint64_t>(clients.size() - 1);
+        };
+        for (const AtomRun& run : runs) {
+            slot(run.client_id);
+            slot(run.origin.client_id);
+        }
+
+        VLEEncoding::encodeUInt64(atom_count, body);
+        VLEEncoding::encodeUInt64(runs.size(), body);
+        VLEEncoding::encodeUInt64(clients.size(), body);
+        for (uint64_t client_id : clients) VLEEncoding::encodeUInt64(client_id, body);
+
+        for (const AtomRun& run : runs) VLEEncoding::encodeUInt64(slot(run.client_id), body);
+        uint64_t prev_clock = 0;
+        for (const AtomRun& run : runs) {
+            VLEEncoding::encodeInt64(static_cast<int64_t>(run.start_clock - prev_clock), body);
+            prev_clock = run.start_clock;
+        }
+        for (const AtomRun& run : runs) VLEEncoding::encodeUInt64(run.length, body);
+        for (const AtomRun& run : runs) VLEEncoding::encodeUInt64(run.step, body);
+        OpID prev_id = {0, 0};
+        for (size_t r = 0; r < runs.size(); r++) {
+            const AtomRun& run = runs[r];
+            if (r > 0 && run.origin == prev_id) {
+                body.push_back(0);
+            } else {
+                VLEEncoding::encodeUInt64(slot(run.origin.client_id) + 1, body);
+                VLEEncoding::encodeInt64(static_cast<int64_t>(run.start_clock - run.origin.clock), body);
+            }
+            prev_id = run.idAt(run.length - 1);
+        }
+
+        // Text is one raw byte per atom; other elements go through ContentCodec
+        size_t content_bytes = kIsText ? atom_count : 0;
+        if constexpr (!kIsText) {
+            for (const AtomChunk* chunk = head; chunk; chunk = chunk->next) {
+                for (size_t offset = 0; offset < chunk->size; offset++) {
+                    ContentCodec<T>::encode(chunk->content[offset], body);
+                }
+            }
+        }
+        size_t bitmap_at = body.size() + content_bytes;
+        body.resize(bitmap_at + (atom_count + 7) / 8, 0);
+        size_t i = 0;
+        for (const AtomChunk* chunk = head; chunk; chunk = chunk->next) {
+            for (size_t offset = 0; offset < chunk->size; offset++, i++) {
+                if constexpr (kIsText) body[bitmap_at - atom_count + i] = static_cast<uint8_t>(chunk->content[offset]);
+                if (chunk->deleted[offset]) body[bitmap_at + i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+            }
+        }
+
+        VLEEncoding::encodeUInt64(delete_log.size(), body);
+        for (const auto& [client_id, log] : delete_log) {
+            VLEEncoding::encodeUInt64(client_id, body);
+            VLEEncoding::encodeUInt64(log.size(), body);
+            uint64_t next_clock = 0;
+            for (const DeleteOp& op : log) {
+                VLEEncoding::encodeUInt64(op.start_clock - next_clock, body);
+                VLEEncoding::encodeUInt64(op.target.client_id, body);
+                VLEEncoding::encodeUInt64(op.target.start_clock, body);
+                VLEEncoding::encodeUInt64(op.target.step, body);
+                VLEEncoding::encodeUInt64(op.target.length, body);
+                next_clock = op.lastClock() + 1;
+            }
+        }
+    }
+
+    /**
+     * @brief Check decoded runs before they are indexed: the first run
+     * starts with the sentinel, and no two runs of a client share an id.
+     * The run index and locate() binary-search on both.
+     */
+    static bool validRuns(const std::vector<AtomRun>& runs) {
+        if (runs.empty() || runs[0].client_id != 0 || runs[0].start_clock != 0) return false;
+
+        struct Span {
+            uint64_t client_id, first, last;
+        };
+        std::vector<Span> spans;
+        spans.reserve(runs.size());
+        for (const AtomRun& run : runs) {
+            uint64_t extent = uint64_t(run.length - 1) * run.step;
+            if (extent > UINT64_MAX - run.start_clock) return false;
+            spans.push_back({run.client_id, run.start_clock, run.start_clock + extent});
+        }
+        std::sort(spans.begin(), spans.end(), [](const Span& a, const Span& b) {
+            return a.client_id != b.client_id ? a.client_id < b.client_id : a.first < b.first;
+        });
+        for (size_t i = 1; i < spans.size(); i++) {
+            if (spans[i].client_id == spans[i - 1].client_id && spans[i].first <= spans[i - 1].last) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Rebuild atoms and the delete log from writeColumns() output.
+     * Expects a freshly reset document.
+     * @return false if the body is malformed (the document is then partial)
+     */
+    bool readColumns(const std::vector<uint8_t>& body) {
+        using network::VLEEncoding;
+        size_t pos = 0;
+        auto next = [&](uint64_t& value) { return VLEEncoding::decodeUInt64(body, pos, value); };
+
+        uint64_t count, run_total, client_total;
+        if (!next(count) || !next(run_total) || !next(client_total)) return false;
+        // Each atom needs a content byte and each run or client at least one byte
+        if (count > body.size() || run_total > count || client_total > body.size()) return false;
+
+        std::vector<uint64_t> clients(client_total);
+        for (uint64_t& client_id : clients) {
+            if (!next(client_id)) return false;
+        }
+
+        std::vector<AtomRun> runs(run_total);
+        for (AtomRun& run : runs) {
+            uint64_t index;
+            if (!next(index) || index >= client_total) return false;
+            run.client_id = clients[index];
+        }
+        uint64_t prev_clock = 0;
+        for (AtomRun& run : runs) {
+            int64_t delta;
+            if (!VLEEncoding::decodeInt64(body, pos, delta)) return false;
+            run.start_clock = prev_clock + static_cast<uint64_t>(delta);
+            prev_clock = run.start_clock;
+        }
+        uint64_t covered = 0;
+        for (AtomRun& run : runs) {
+            uint64_t length;
+            if (!next(length) || length == 0 || length > count - covered || length > UINT32_MAX) return false;
+            run.length = static_cast<uint32_t>(length);
+            covered += length;
+        }
+        if (covered != count) return false;
+        for (AtomRun& run : runs) {
+            uint64_t step;
+            if (!next(step) || step == 0 || step > AtomRun::kMaxStep) return false;
+            run.step = static_cast<uint32_t>(step);
+        }
+        OpID prev_id = {0, 0};
+        for (AtomRun& run : runs) {
+            uint64_t tag;
+            if (!next(tag) || tag > client_total) return false;
+            if (tag == 0) {
+                run.origin = prev_id;
+            } else {
+                int64_t distance;
+                if (!VLEEncoding::decodeInt64(body, pos, distance)) return false;
+                run.origin = {clients[tag - 1], run.start_clock - static_cast<uint64_t>(distance)};
+            }
+            prev_id = run.idAt(run.length - 1);
+        }
+        if (!validRuns(runs)) return false;
+
+        std::vector<T> values;
+        if constexpr (!kIsText) {
+            values.resize(count);
+            for (T& value : values) {
+                if (!ContentCodec<T>::decode(body, pos, value)) return false;
+            }
+        }
+        size_t bitmap_at = kIsText ? pos + count : pos;
+        if (body.size() < bitmap_at || body.size() - bitmap_at < (count + 7) / 8) return false;
+        size_t i = 0;
+        for (const AtomRun& run : runs) {
+            for (size_t j = 0; j < run.length; j++, i++) {
+                T value;
+                if constexpr (kIsText) value = static_cast<char>(body[pos + i]);
+                else value = values[i];
+                Atom a(run.idAt(j), run.originAt(j), value);
+                a.is_deleted = (body[bitmap_at + i / 8] >> (i % 8)) & 1;
+                appendAtomUnindexed(a);
+                if (a.is_deleted) tombstone_count++;
+            }
+        }
+        buildIndex();
+        pos = bitmap_at + (count + 7) / 8;
+
+        uint64_t log_clients;
+        if (!next(log_clients) || log_clients > body.size() - pos) return false;
+        for (uint64_t c = 0; c < log_clients; c++) {
+            uint64_t client_id, records;
+            if (!next(client_id) || !next(records) || records > body.size() - pos) return false;
+            std::vector<DeleteOp>& log = delete_log[client_id];
+            delete_log_stamps[client_id] = ++edit_stamp;
+            uint64_t next_clock = 0;
+            for (uint64_t k = 0; k < records; k++) {
+                DeleteOp op;
+                uint64_t gap;
+                op.client_id = client_id;
+                if (!next(gap) || !next(op.target.client_id) || !next(op.target.start_clock) ||
+                    !next(op.target.step) || !next(op.target.length)) {
+                    return false;
+                }
+                if (op.target.step == 0 || op.target.length == 0) return false;
+                op.start_clock = next_clock + gap;
+                if (op.start_clock < next_clock || op.start_clock > UINT64_MAX - op.target.length) return false;
+                log.push_back(op);
+                next_clock = op.lastClock() + 1;
+            }
+        }
+        return pos == body.size();
+    }
+
+    AVLNode* buildSubtree(const std::vector<AVLNode*>& nodes, size_t lo, size_t hi, AVLNode* parent) {
+        if (lo == hi) return nullptr;
+        size_t mid = lo + (hi - lo) / 2;
+        AVLNode* n = nodes[mid];
+        n->parent = parent;
+        n->left = buildSubtree(nodes, lo, mid, n);
+        n->right = buildSubtree(nodes, mid + 1, hi, n);
+        updateHeightAndWeight(n);
+        return n;
+    }
+
+    /**
+     * @brief Flag the atom at `pos` as a tombstone.
+     */
+    void markDeleted(AtomPos pos) {
+        AtomChunk* chunk = pos.chunk;
+        bool was_visible = chunk->visible(pos.offset);
+        chunk->deleted[pos.offset] = true;
+        touch(chunk);
+        if (!chunk->isSentinel(pos.offset)) indexTombstone(chunk->idAt(pos.offset));
+        if (was_visible) {
+            updateWeight(chunk->node, chunk->node->weight - 1);
+            if (text_cache_valid) recordTextPatch(visibleIndex(pos), 1, {});
+        }
+    }
+
+    /**
+     * @brief Track a tombstone so GC can find it without walking the rope.
+     */
+    void indexTombstone(const OpID& id) {
+        tombstone_index[id.client_id].insert(id.clock);
+    }
+
+    void unindexTombstone(const OpID& id) {
+        auto it = tombstone_index.find(id.client_id);
+        if (it == tombstone_index.end()) return;
+        it->second.erase(id.clock);
+        if (it->second.empty()) tombstone_index.erase(id.client_id);
+    }
+
+    /**
+     * @brief Up to `limit` tombstones with clock <= bound(client), in
+     * client/clock order.
+     */
+    template <typename Bound>
+    std::vector<OpID> collectTombstones(Bound bound, size_t limit) const {
+        std::vector<OpID> ids;
+        for (const auto& [client_id, clocks] : tombstone_index) {
+            auto end = clocks.upper_bound(bound(client_id));
+            for (auto it = clocks.begin(); it != end && ids.size() < limit; ++it) ids.push_back({client_id, *it});
+            if (ids.size() == limit) break;
+        }
+        return ids;
+    }
+
+    /**
+     * @brief Remove the atom at `pos`, merging sparse chunks with a neighbor.
+     */
+    void eraseAtom(AtomPos pos) {
+        AtomChunk* chunk = pos.chunk;
+        size_t run_offset;
+        size_t r = chunk->runAt(pos.offset, run_offset);
+        size_t k = pos.offset - run_offset;
+
+        if (k > 0 && k + 1 < chunk->runs[r].length && chunk->run_count == AtomChunk::kMaxRuns) {
+            // Splitting the run needs a free slot
+            OpID id = chunk->runs[r].idAt(k);
+            splitChunk(chunk);
+            eraseAtom(locate(id));
+            return;
+        }
+
+        AtomRun& run = chunk->runs[r];
+        if (run.length == 1) {
+            unindexRun(run);
+            chunk->eraseRun(r);
+            if (r > 0) coalesceRuns(chunk, r - 1);
+        } else if (k == 0) {
+            unindexRun(run);
+            run.origin = run.idAt(0);
+            run.start_clock += run.step;
+            run.length--;
+            indexRun(run, chunk);
+        } else if (k + 1 == run.length) {
+            run.length--;
+        } else {
+            AtomRun piece = {run.client_id, run.idAt(k + 1).clock, run.idAt(k),
+                             static_cast<uint32_t>(run.length - k - 1), run.step};
+            run.length = static_cast<uint32_t>(k);
+            chunk->insertRun(r + 1, piece);
+            indexRun(piece, chunk);
+        }
+
+        bool was_visible = chunk->visible(pos.offset);
+        chunk->eraseSlot(pos.offset);
+        touch(chunk);
+        atom_count--;
+        if (was_visible) updateWeight(chunk->node, chunk->node->weight - 1);
+        refreshOriginBound(chunk);
+
+        if (chunk->size == 0) {
+            removeChunk(chunk);
+        } else if (chunk->size < AtomChunk::kCapacity / 4) {
+            AtomChunk* prev = chunk->prev;
+            AtomChunk* next = chunk->next;
+            if (prev && prev->size + chunk->size <= AtomChunk::kCapacity &&
+                prev->run_count + chunk->run_count <= AtomChunk::kMaxRuns) {
+                moveAtoms(chunk, 0, prev);
+                removeChunk(chunk);
+            } else if (next && chunk->size + next->size <= AtomChunk::kCapacity &&
+                       chunk->run_count + next->run_count <= AtomChunk::kMaxRuns) {
+                moveAtoms(next, 0, chunk);
+                removeChunk(next);
+            }
+        }
+    }
+
+    /**
+     * @brief Visible index of the atom at `pos` (visible atoms before it).
+     */
+    size_t visibleIndex(AtomPos pos) const {
+        const AVLNode* node = pos.chunk->node;
+        size_t index = pos.chunk->visibleCount(0, pos.offset);
+        if (node->left) index += node->left->subtree_weight;
+        for (const AVLNode* parent = node->parent; parent; node = parent, parent = parent->parent) {
+            if (parent->right == node) {
+                index += parent->weight + (parent->left ? parent->left->subtree_weight : 0);
+            }
+        }
+        return index;
+    }
+
+    /**
+     * @brief Queue a text edit for the cached view (no-op while it is cold).
+     * Typing and backspacing runs fold into one patch.
+     */
+    void recordTextPatch(size_t index, size_t erase, std::string_view insert) {
+        if (!text_cache_valid) return;
+        if (!text_patches.empty()) {
+            TextPatch& last = text_patches.back();
+            if (erase == 0 && last.erase == 0 && index == last.index + last.insert.size()) {
+                last.insert += insert;
+                return;
+            }
+            if (insert.empty() && last.insert.empty()) {
+                if (index == last.index) {
+                    last.erase += erase;
+                    return;
+                }
+                if (index + erase == last.index) {
+                    last.index = index;
+                    last.erase += erase;
+                    return;
+                }
+            }
+        }
+        if (text_patches.size() == kMaxTextPatches) {
+            invalidateText();
+            return;
+        }
+        text_patches.push_back({index, erase, std::string(insert)});
+    }
+
+    void invalidateText() {
+        text_cache_valid = false;
+        text_patches.clear();
+    }
+
+    /**
+     * @brief Release every chunk and index node by dropping their slabs.
+     */
+    void destroyRope() {
+        chunk_pool.release();
+        node_pool.release();
+        head = tail = nullptr;
+        root = nullptr;
+        last_chunk.store(nullptr, std::memory_order_relaxed);
+        atom_count = 0;
+        chunk_count = 0;
+        run_count = 0;
+        invalidateText();
+    }
+
+    /**
+     * @brief Reset storage to a single empty chunk.
+     */
+    void initRope() {
+        head = tail = chunk_pool.create();
+        root = node_pool.create(head, 0);
+        head->node = root;
+        chunk_count = 1;
+        touch(head);
+    }
+
+public:
+    BasicSequence(uint64_t client_id, const Allocator& alloc = Allocator())
+        : my_client_id(client_id), vector_clock(client_id),
+          chunk_pool(alloc), node_pool(alloc) {
+        OpID start_id = {0, 0};
+        initRope();
+        insertAtom({head, 0}, Atom(start_id, start_id, T()));
+    }
+
+    ~BasicSequence() {
+        destroyRope();
+    }
+
+    BasicSequence(const BasicSequence&) = delete;
+    BasicSequence& operator=(const BasicSequence&) = delete;
+
+    BasicSequence(BasicSequence&& other) noexcept 
+        : my_client_id(other.my_client_id),
+          clock(std::move(other.clock)),
+          vector_clock(std::move(other.vector_clock)),
+          chunk_pool(std::move(other.chunk_pool)),
+          node_pool(std::move(other.node_pool)),
+          head(other.head),
+          tail(other.tail),
+          atom_count(other.atom_count),
+          chunk_count(other.chunk_count),
+          edit_stamp(other.edit_stamp),
+          run_index(std::move(other.run_index)),
+          run_count(other.run_count),
+          last_chunk(other.last_chunk.load(std::memory_order_relaxed)),
+          child_index(std::move(other.child_index)),
+          root(other.root),
+          pending_orphans(std::move(other.pending_orphans)),
+          orphan_queue(std::move(other.orphan_queue)),
+          orphan_seq(other.orphan_seq),
+          pending_deletes(std::move(other.pending_deletes)),
+          delete_log(std::move(other.delete_log)),
+          delete_log_stamps(std::move(other.delete_log_stamps)),
+          gc_config(other.gc_config),
+          tombstone_count(other.tombstone_count),
+          tombstone_index(std::move(other.tombstone_index)),
+          orphan_config(other.orphan_config),
+          total_orphan_count(other.total_orphan_count),
+          orphan_stats_(other.orphan_stats_),
+          gc_stats_(other.gc_stats_),
+          text_cache(std::move(other.text_cache)),
+          text_patches(std::move(other.text_patches)),
+          text_cache_valid(other.text_cache_valid) {
+        other.invalidateText();
+        other.head = other.tail = nullptr;
+        other.root = nullptr;
+        other.last_chunk.store(nullptr, std::memory_order_relaxed);
+        other.atom_count = 0;
+        other.chunk_count = 0;
+        other.run_count = 0;
+    }
+
+    BasicSequence& operator=(BasicSequence&& other) noexcept {
+        if (this != &other) {
+            destroyRope();
+            my_client_id = other.my_client_id;
+            clock = std::move(other.clock);
+            vector_clock = std::move(other.vector_clock);
+            chunk_pool = std::move(other.chunk_pool);
+            node_pool = std::move(other.node_pool);
+            head = other.head;
+            tail = other.tail;
+            atom_count = other.atom_count;
+            chunk_count = other.chunk_count;
+            edit_stamp = std::max(edit_stamp, other.edit_stamp);
+            run_index = std::move(other.run_index);
+            run_count = other.run_count;
+            last_chunk.store(other.last_chunk.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            child_index = std::move(other.child_index);
+            root = other.root;
+            pending_orphans = std::move(other.pending_orphans);
+            orphan_queue = std::move(other.orphan_queue);
+            orphan_seq = other.orphan_seq;
+            pending_deletes = std::move(other.pending_deletes);
+            delete_log = std::move(other.delete_log);
+            delete_log_stamps = std::move(other.delete_log_stamps);
+            for (auto& entry : delete_log_stamps) entry.second = ++edit_stamp;  // Unlike any earlier version's
+            gc_config = other.gc_config;
+            tombstone_count = other.tombstone_count;
+            tombstone_index = std::move(other.tombstone_index);
+            orphan_config = other.orphan_config;
+            total_orphan_count = other.total_orphan_count;
+            orphan_stats_ = other.orphan_stats_;
+            gc_stats_ = other.gc_stats_;
+            text_cache = std::move(other.text_cache);
+            text_patches = std::move(other.text_patches);
+            text_cache_valid = other.text_cache_valid;
+            other.invalidateText();
+            other.head = other.tail = nullptr;
+            other.root = nullptr;
+            other.last_chunk.store(nullptr, std::memory_order_relaxed);
+            other.atom_count = 0;
+            other.chunk_count = 0;
+            other.run_count = 0;
+        }
+        return *this;
+    }
+
+    Atom localInsert(size_t literal_index, T content) {
+        uint64_t tick = clock.tick();
+        vector_clock.tick(); // Update vector clock too
+        OpID new_id = { my_client_id, tick };
+
+        AtomPos parent_pos = findByPrefixWeight(literal_index);
+        OpID parent_id = parent_pos.chunk ? parent_pos.chunk->idAt(parent_pos.offset) : OpID{0, 0};
+        Atom new_atom(new_id, parent_id, content);
+        
+        // UNIFIED LOGIC: Treat local inserts exactly like remote ones.
+        remoteMerge(new_atom);
+
+        return new_atom;
+    }
+
+    /**
+     * @brief Insert a whole string at `literal_index` as one batch (paste).
+     *
+     * Same result as inserting text[0] at `literal_index` and typing the
+     * rest right after it: each later character's origin is the one before
+     * it, so only the first atom goes through the RGA scan and the rest form
+     * a single run. Atoms are written into chunks in bulk and the index is
+     * updated once per chunk instead of once per character.
+     *
+     * @return The insert operations in order, ready to broadcast.
+     */
+    std::vector<Atom> localInsertString(size_t literal_index, std::basic_string_view<T> text) {
+        return localInsertRange(literal_index, text.data(), text.size());
+    }
+
+    /**
+     * @brief localInsertString() for element types without a string view.
+     */
+    std::vector<Atom> localInsertRange(size_t literal_index, const T* items, size_t count) {
+        std::vector<Atom> ops;
+        if (count == 0) return ops;
+        ops.reserve(count);
+
+        AtomPos parent_pos = findByPrefixWeight(literal_index);
+        OpID origin = parent_pos.chunk ? parent_pos.chunk->idAt(parent_pos.offset) : OpID{0, 0};
+        for (const T* c = items; c != items + count; ++c) {
+            // Same clock steps as one localInsert per character
+            uint64_t tick = clock.tick();
+            vector_clock.tick();
+            clock.merge(tick);
+            vector_clock.update(my_client_id, tick);
+
+            ops.emplace_back(OpID{my_client_id, tick}, origin, *c);
+            origin = ops.back().id;
+        }
+
+        // Record the paste as one text patch instead of one per chunk
+        bool track_text = text_cache_valid;
+        text_cache_valid = false;
+        integrateAtom(ops.front());
+        AtomPos first = locate(ops.front().id);
+        if (first.chunk) insertChain(first, ops, 1);
+        text_cache_valid = track_text;
+        if (first.chunk && first.chunk->visible(first.offset)) {
+            if constexpr (kIsText) recordTextPatch(visibleIndex(first), 0, std::string_view(items, count));
+        } else {
+            invalidateText();
+        }
+        expireOrphans();
+
+        // Auto-GC check
+        if (autoGCDue()) {
+            autoCollect();
+        }
+
+        return ops;
+    }
+
+    void remoteMerge(Atom new_atom) {
+        clock.merge(new_atom.id.clock);
+        vector_clock.update(new_atom.id.client_id, new_atom.id.clock);
+        expireOrphans();
+
+        if (!integrateAtom(new_atom)) return;
+        
+        // Auto-GC check (applyDelta runs it once per batch)
+        if (!applying_batch && autoGCDue()) {
+            autoCollect();
+        }
+    }
+
+private:
+    /**
+     * @brief Place an atom (or buffer it as an orphan) without clock updates.
+     * @return True if the atom was added to the document.
+     */
+    bool integrateAtom(const Atom& new_atom) {
+        if (contains(new_atom.id)) return false;
+        splitSpanningRun(new_atom.id, true);
+
+        AtomPos parent_pos = locate(new_atom.origin);
+        if (!parent_pos.chunk) {
+            // Causal input: the origin was lost, nothing will unblock this atom
+            if constexpr (!Policy::kBufferOutOfOrder) return false;
+
+            // Orphan: parent doesn't exist yet
+            expireOrphans();
+            if (total_orphan_count >= orphan_config.max_orphan_buffer_size) {
+                evictOldOrphans();
+            }
+            uint64_t seq = orphan_seq++;
+            pending_orphans[new_atom.origin].push_back({new_atom, seq});
+            orphan_queue.emplace_hint(orphan_queue.end(), seq, OrphanEntry{clock.peek(), new_atom.origin});
+            total_orphan_count++;
+            orphan_stats_.buffered++;
+            return false;
+        }
+
+        AtomPos pos = scanForInsert(parent_pos, new_atom);
+        AtomPos new_pos = insertAtom(pos, new_atom);
+        
+        if constexpr (Policy::kBufferOutOfOrder) {
+            if (pending_deletes.erase(new_atom.id)) {
+                markDeleted(new_pos);
+                tombstone_count++;
+            }
+
+            checkPendingOrphans(new_atom.id);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Run covering ops[from, from + length), a chain of local inserts.
+     */
+    AtomRun chainRun(const std::vector<Atom>& ops, size_t from, size_t length) const {
+        uint64_t step = length > 1 ? ops[from + 1].id.clock - ops[from].id.clock : 1;
+        return {my_client_id, ops[from].id.clock, ops[from].origin,
+                static_cast<uint32_t>(length), static_cast<uint32_t>(step)};
+    }
+
+    /**
+     * @brief Write ops[from, from + length) into `chunk` at `offset`, which
+     * must follow the last atom of a run. The caller checks capacity.
+     */
+    void writeChain(AtomChunk* chunk, size_t offset, const std::vector<Atom>& ops, size_t from, size_t length) {
+        AtomRun piece = chainRun(ops, from, length);
+        size_t r = 0;
+        if (offset > 0) {
+            size_t run_offset;
+            r = chunk->runAt(offset - 1, run_offset) + 1;
+        }
+
+        chunk->openSlots(offset, length);
+        for (size_t i = 0; i < length; i++) chunk->content[offset + i] = ops[from + i].content;
+        touch(chunk);
+
+        if (r > 0 && joins(chunk->runs[r - 1], piece)) {
+            chunk->runs[r - 1].append(piece);
+        } else {
+            chunk->insertRun(r, piece);
+            indexRun(piece, chunk);
+        }
+        atom_count += length;
+        updateWeight(chunk->node, chunk->node->weight + chunk->visibleCount(offset, offset + length));
+        lowerOriginBound(chunk, ops[from].origin.clock);  // Later origins are later atoms
+    }
+
+    /**
+     * @brief Can `length` chained atoms go into `chunk` right after `offset - 1`?
+     */
+    bool chainFits(const AtomChunk* chunk, size_t offset, const std::vector<Atom>& ops, size_t from, size_t length) const {
+        if (chunk->size + length > AtomChunk::kCapacity) return false;
+        if (offset == 0) return chunk->run_count < AtomChunk::kMaxRuns;
+        size_t run_offset;
+        size_t r = chunk->runAt(offset - 1, run_offset);
+        if (offset - run_offset != chunk->runs[r].length) return false;  // Would split a run
+        return joins(chunk->runs[r], chainRun(ops, from, length)) ||
+               chunk->run_count < AtomChunk::kMaxRuns;
+    }
+
+    /**
+     * @brief Insert ops[from, end) right after the atom at `pos`.
+     *
+     * Small chains are spliced into the chunk in place. Longer ones cut the
+     * chunk after `pos` and stream into the chunk end, adding fresh chunks as
+     * each one fills up.
+     */
+    void insertChain(AtomPos pos, const std::vector<Atom>& ops, size_t from) {
+        AtomChunk* chunk = pos.chunk;
+        size_t offset = pos.offset + 1;
+        size_t remaining = ops.size() - from;
+        if (remaining == 0) return;
+
+        if (chainFits(chunk, offset, ops, from, remaining)) {
+            writeChain(chunk, offset, ops, from, remaining);
+            return;
+        }
+
+        if (offset < chunk->size) {
+            AtomChunk* right = insertChunkAfter(chunk);
+            moveAtoms(chunk, offset, right);
+        }
+
+        while (remaining > 0) {
+            size_t length = std::min(remaining, AtomChunk::kCapacity - chunk->size);
+            if (length == 0 || !chainFits(chunk, chunk->size, ops, from, length)) {
+                chunk = insertChunkAfter(chunk);
+                continue;
+            }
+            writeChain(chunk, chunk->size, ops, from, length);
+            from += length;
+            remaining -= length;
+        }
+        last_chunk.store(chunk, std::memory_order_relaxed);
+    }
+
+public:
+    OpID localDelete(size_t literal_index) {
+        uint64_t tick = clock.tick();
+        vector_clock.tick();
+        expireOrphans();
+
+        AtomPos target = findByPrefixWeight(literal_index + 1);
+        if (target.chunk && target.chunk->visible(target.offset)) {
+            OpID deleted_id = target.chunk->idAt(target.offset);
+            markDeleted(target);
+            tombstone_count++;
+            logDeleteOp({my_client_id, tick, {deleted_id.client_id, deleted_id.clock, 1, 1}});
+            
+            // Auto-GC check
+            if (autoGCDue()) {
+                autoCollect();
+            }
+            
+            return deleted_id;
+        }
+        return {0,0};
+    }
+
+    void remoteDelete(OpID target_id) {
+        AtomPos pos = locate(target_id);
+        if (pos.chunk) {
+            if (!pos.chunk->deleted[pos.offset]) {
+                markDeleted(pos);
+                tombstone_count++;
+            }
+        } else if constexpr (Policy::kBufferOutOfOrder) {
+            pending_deletes.insert(target_id);
+        }
+    }
+
+    /**
+     * @brief Delete `length` visible characters starting at `literal_index`.
+     *
+     * Flags the whole range in one walk over the affected chunks and
+     * refreshes the index weights bottom-up once. The range is clipped to
+     * the end of the document.
+     *
+     * @return The deleted ids as compact spans, ready to broadcast.
+     */
+    std::vector<DeleteSpan> localDeleteRange(size_t literal_index, size_t length) {
+        std::vector<DeleteSpan> spans;
+        size_t visible = root ? root->subtree_weight : 0;
+        if (length == 0 || literal_index >= visible) return spans;
+        length = std::min(length, visible - literal_index);
+
+        AtomPos pos = findByPrefixWeight(literal_index + 1);
+        AtomChunk* chunk = pos.chunk;
+        size_t offset = pos.offset;
+        std::vector<AVLNode*> dirty;
+        recordTextPatch(literal_index, length, {});
+        uint64_t first_tick = clock.peek() + 1;
+
+        while (length > 0) {
+            size_t removed = 0;
+            size_t run_offset;
+            size_t r = chunk->runAt(offset, run_offset);
+            for (; r < chunk->run_count && length > 0; r++) {
+                const AtomRun& run = chunk->runs[r];
+                for (size_t j = offset - run_offset; j < run.length && length > 0; j++, offset++) {
+                    if (!chunk->visible(offset)) continue;
+                    chunk->deleted[offset] = true;
+                    touch(chunk);
+                    removed++;
+                    length--;
+
+                    OpID id = run.idAt(j);
+                    indexTombstone(id);
+                    if (spans.empty() || !spans.back().extendWith(id)) {
+                        spans.push_back({id.client_id, id.clock, 1, 1});
+                    }
+                }
+                run_offset = offset;
+            }
+            if (removed) setWeightDeferred(chunk->node, chunk->node->weight - removed, dirty);
+            tombstone_count += removed;
+            for (size_t i = 0; i < removed; i++) {
+                // Same clock steps as one localDelete per character
+                clock.tick();
+                vector_clock.tick();
+            }
+            chunk = chunk->next;
+            offset = 0;
+        }
+        refreshWeights(dirty);
+
+        // One delete op per atom, in the order the clock ticked for them
+        uint64_t tick = first_tick;
+        for (const DeleteSpan& span : spans) {
+            logDeleteOp({my_client_id, tick, span});
+            tick += span.length;
+        }
+        expireOrphans();
+
+        // Auto-GC check
+        if (autoGCDue()) {
+            autoCollect();
+        }
+
+        return spans;
+    }
+
+    /**
+     * @brief Apply range deletes received from a peer.
+     * Ids that have not arrived yet are buffered like single deletes.
+     * Ids past the newest clock seen from their client are buffered only
+     * while the delete buffer is under max_orphan_buffer_size; the rest of
+     * the span is dropped, so a forged length can't run the loop away.
+     */
+    void remoteDeleteRange(const std::vector<DeleteSpan>& spans) {
+        std::vector<AVLNode*> dirty;
+        AtomChunk* chunk = nullptr;
+        for (const DeleteSpan& span : spans) {
+            if (!span.valid()) continue;
+            uint64_t length = span.countThrough(vector_clock.get(span.client_id));
+            if constexpr (Policy::kBufferOutOfOrder) {
+                size_t limit = orphan_config.max_orphan_buffer_size;
+                size_t room = limit > pending_deletes.size() ? limit - pending_deletes.size() : 0;
+                length += std::min<uint64_t>(span.length - length, room);
+            }
+            for (uint64_t j = 0; j < length; j++) {
+                OpID id = span.idAt(j);
+                size_t offset = chunk ? chunk->find(id) : 0;
+                if (!chunk || offset == chunk->size) {
+                    AtomPos pos = locate(id);
+                    if (!pos.chunk) {
+                        if constexpr (Policy::kBufferOutOfOrder) pending_deletes.insert(id);
+                        continue;
+                    }
+                    chunk = pos.chunk;
+                    offset = pos.offset;
+                }
+                if (chunk->deleted[offset]) continue;
+                if (chunk->visible(offset)) {
+                    setWeightDeferred(chunk->node, chunk->node->weight - 1, dirty);
+                    invalidateText();
+                }
+                chunk->deleted[offset] = true;
+                touch(chunk);
+                if (!chunk->isSentinel(offset)) indexTombstone(id);
+                tombstone_count++;
+            }
+        }
+        refreshWeights(dirty);
+    }
+
+    /**
+     * @brief Delete operations the peer has not seen, by op clock.
+     *
+     * Every local delete is logged with its own OpID, so deleting an old
+     * character reaches peers that already have its insert. Contiguous
+     * deletes share one record. Records the peer partly has are trimmed.
+     */
+    std::vector<DeleteOp> getDeleteDelta(const VectorClock& peer_state) const {
+        std::vector<DeleteOp> ops;
+        for (const auto& [client_id, log] : delete_log) {
+            appendUnseenDeleteOps(log, peer_state.get(client_id), ops);
+        }
+        return ops;
+    }
+
+    /**
+     * @brief Apply delete operations from a peer (getDeleteDelta output).
+     * Ops are logged so they can be relayed; ones already logged are skipped.
+     * Malformed ops (see DeleteOp::valid) are dropped before they touch the
+     * clock or the log. Targets are applied before the op clocks are merged,
+     * so remoteDeleteRange bounds them by the clocks known before the batch.
+     */
+    void applyDeleteOps(const std::vector<DeleteOp>& ops) {
+        std::vector<DeleteSpan> targets;
+        for (const DeleteOp& op : ops) {
+            if (!op.valid()) continue;
+            for (const DeleteOp& fresh : logDeleteOp(op)) targets.push_back(fresh.target);
+        }
+        remoteDeleteRange(targets);
+
+        for (const DeleteOp& op : ops) {
+            if (!op.valid()) continue;
+            clock.merge(op.lastClock());
+            vector_clock.update(op.client_id, op.lastClock());
+        }
+    }
+
+    /**
+     * @brief DELTA SYNC: Get operations that peer is missing.
+     * @param peer_state The vector clock representing what the peer has seen.
+     * @return Vector of atoms that are new to the peer.
+     * 
+     * Example:
+     *   My state: {A:5, B:3}
+     *   Peer state: {A:3, B:3}
+     *   Delta: All operations from A with clock > 3
+     *
+     * Cost is O(clients + delta log delta), not O(document): each client's
+     * runs are range-scanned from the peer's clock. Atoms come back sorted
+     * by OpID, so parents arrive before their children.
+     */
+    std::vector<Atom> getDelta(const VectorClock& peer_state) const {
+        std::vector<Atom> delta;
+
+        // Per-client range scans over the run index: only runs that may hold
+        // clocks the peer has not seen are visited
+        for (const auto& [client_id, runs] : run_index) {
+            uint64_t peer_time = peer_state.get(client_id);
+            auto it = runs.upper_bound(peer_time);
+            if (it != runs.begin()) --it;  // May straddle peer_time
+            for (; it != runs.end(); ++it) {
+                const AtomChunk* chunk = it->second;
+                size_t run_offset;
+                const AtomRun& run = chunk->runs[chunk->findRun({client_id, it->first}, run_offset)];
+                for (size_t j = 0; j < run.length; j++) {
+                    // Peer hasn't seen this operation (never true for the start node)
+                    if (run.idAt(j).clock <= peer_time) continue;
+                    Atom atom(run.idAt(j), run.originAt(j), chunk->content[run_offset + j]);
+                    atom.is_deleted = chunk->deleted[run_offset + j];
+                    delta.push_back(atom);
+                }
+            }
+        }
+
+        // Lamport order: every origin precedes the atoms inserted after it
+        std::sort(delta.begin(), delta.end(),
+                  [](const Atom& a, const Atom& b) { return a.id < b.id; });
+        return delta;
+    }
+
+    /**
+     * @brief DELTA SYNC: Apply a delta from another peer.
+     * @param delta Vector of atoms received from peer.
+     * 
+     * This is more efficient than sending the entire document.
+     * Instead of sending 10,000 atoms, we might only send 5.
+     *
+     * The batch is applied in causal order: sorting by OpID (skipped when
+     * the delta is already sorted, as getDelta's output is) puts every
+     * origin ahead of the atoms inserted after it, so a catch-up delta
+     * doesn't bounce through the orphan buffer. Index capacity is reserved
+     * up front, auto-GC runs once at the end, and large batches rebuild the
+     * text view once instead of patching it per atom.
+     *
+     * Deleted atoms are placed as tombstones, so atoms inserted after them
+     * still find their origin.
+     *
+     * @return Counters for the batch.
+     */
+    DeltaStats applyDelta(const std::vector<Atom>& delta) {
+        std::chrono::high_resolution_clock::time_point start;
+        if constexpr (Policy::kTimed) start = std::chrono::high_resolution_clock::now();
+        DeltaStats stats;
+        stats.received = delta.size();
+
+        auto by_id = [](const Atom& a, const Atom& b) { return a.id < b.id; };
+        std::vector<Atom> sorted;
+        const std::vector<Atom>* batch = &delta;
+        if (!std::is_sorted(delta.begin(), delta.end(), by_id)) {
+            sorted = delta;
+            std::sort(sorted.begin(), sorted.end(), by_id);
+            batch = &sorted;
+        }
+
+        // Each atom that doesn't continue its client's previous one starts a run
+        size_t new_runs = 0;
+        for (const Atom& atom : *batch) {
+            bool continues = atom.origin.client_id == atom.id.client_id && atom.id.clock > atom.origin.clock &&
+                             atom.id.clock - atom.origin.clock <= AtomRun::kMaxStep;
+            if (!continues) new_runs++;
+        }
+        child_index.reserve(child_index.size() + new_runs);
+
+        if (delta.size() > kMaxTextPatches) invalidateText();
+        size_t atoms_before = atom_count;
+        size_t orphans_before = total_orphan_count;
+        size_t tombstones_before = tombstone_count;
+
+        applying_batch = true;
+        for (const Atom& atom : *batch) {
+            clock.merge(atom.id.clock);
+            vector_clock.update(atom.id.client_id, atom.id.clock);
+
+            if (contains(atom.id)) {
+                stats.duplicates++;
+                if (atom.is_deleted) remoteDelete(atom.id);
+                continue;
+            }
+            Atom live = atom;
+            live.is_deleted = false;
+            if constexpr (Policy::kBufferOutOfOrder) {
+                if (atom.is_deleted) pending_deletes.insert(atom.id);  // Flagged once placed
+                integrateAtom(live);
+            } else if (integrateAtom(live) && atom.is_deleted) {
+                remoteDelete(atom.id);
+            }
+        }
+        applying_batch = false;
+        expireOrphans();  // The batch advanced the clock even if nothing new was orphaned
+
+        stats.applied = atom_count - atoms_before;
+        stats.orphaned = total_orphan_count > orphans_before ? total_orphan_count - orphans_before : 0;
+        stats.tombstones = tombstone_count - tombstones_before;
+        if (autoGCDue()) {
+            stats.gc_removed = autoCollect();
+        }
+
+        if constexpr (Policy::kTimed) {
+            auto end = std::chrono::high_resolution_clock::now();
+            stats.apply_time_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        }
+        return stats;
+    }
+
     /**
      * @brief Get the current vector clock state.
      * Peers use this to determine what they're missing.
@@ -507,6 +2257,17 @@ public:
         return vector_clock;
     }
 
+    uint64_t getClientId() const {
+        return my_client_id;
+    }
+
+    /**
+     * @brief Current Lamport time. Every later local op gets a larger clock.
+     */
+    uint64_t getClock() const {
+        return clock.peek();
+    }
+
     /**
      * @brief Merge peer's vector clock (for tracking what they've seen).
      */
@@ -524,32 +2285,24 @@ public:
      * can be safely deleted without breaking convergence.
      */
     size_t garbageCollect(const VectorClock& stable_frontier) {
-        auto start = std::chrono::steady_clock::now();
-        
-        std::vector<OpID> to_remove;
-        
-        for (const auto& atom : atoms) {
-            // Skip start node
-            if (atom.id.client_id == 0 && atom.id.clock == 0) continue;
-            
-            // Only remove tombstones
-            if (!atom.is_deleted) continue;
-            
-            // Check if this atom is before the stable frontier
-            uint64_t frontier_time = stable_frontier.get(atom.id.client_id);
-            if (atom.id.clock <= frontier_time) {
-                to_remove.push_back(atom.id);
-            }
-        }
-        
-        removeTombstones(to_remove);
-        
-        // Record GC performance
-        auto end = std::chrono::steady_clock::now();
-        auto duration_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-        gc_stats_.recordGCRun(duration_us, to_remove.size());
-        
-        return to_remove.size();
+        return garbageCollectStep(stable_frontier, 0);
+    }
+
+    /**
+     * @brief Incremental garbageCollect(): stop after `max_items` removals or
+     * once `budget_us` microseconds have passed, whichever comes first.
+     * @param max_items Removal cap for this step (0 = no cap)
+     * @param budget_us Time budget for this step (0 = no budget)
+     * @return Number of tombstones removed
+     *
+     * Tombstones left over stay indexed, so the next step resumes with them.
+     * The time budget is checked every few removals, so a step always makes
+     * some progress.
+     */
+    size_t garbageCollectStep(const VectorClock& stable_frontier, size_t max_items, uint64_t budget_us = 0) {
+        // Only tombstones before the stable frontier
+        return collectGarbage([&](uint64_t client_id) { return stable_frontier.get(client_id); },
+                              max_items, budget_us);
     }
     
     /**
@@ -561,32 +2314,19 @@ public:
      * Useful for single-user applications or offline editing.
      */
     size_t garbageCollectLocal(uint64_t min_age_threshold) {
-        auto start = std::chrono::steady_clock::now();
-        
+        return garbageCollectLocalStep(min_age_threshold, 0);
+    }
+
+    /**
+     * @brief Incremental garbageCollectLocal(), bounded like garbageCollectStep().
+     */
+    size_t garbageCollectLocalStep(uint64_t min_age_threshold, size_t max_items, uint64_t budget_us = 0) {
         uint64_t current_time = clock.peek();
         uint64_t safe_time = (current_time > min_age_threshold) ? 
                              (current_time - min_age_threshold) : 0;
         
-        std::vector<OpID> to_remove;
-        
-        for (const auto& atom : atoms) {
-            if (atom.id.client_id == 0 && atom.id.clock == 0) continue;
-            if (!atom.is_deleted) continue;
-            
-            // Only remove if clock is old enough
-            if (atom.id.clock <= safe_time) {
-                to_remove.push_back(atom.id);
-            }
-        }
-        
-        removeTombstones(to_remove);
-        
-        // Record GC performance
-        auto end = std::chrono::steady_clock::now();
-        auto duration_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-        gc_stats_.recordGCRun(duration_us, to_remove.size());
-        
-        return to_remove.size();
+        // Only remove if clock is old enough
+        return collectGarbage([&](uint64_t) { return safe_time; }, max_items, budget_us);
     }
     
     /**
@@ -623,19 +2363,28 @@ public:
     MemoryStats getMemoryStats() const {
         MemoryStats stats;
         
-        stats.atom_count = atoms.size();
+        stats.atom_count = atom_count;
         stats.tombstone_count = tombstone_count;
         stats.orphan_count = total_orphan_count;
         stats.delete_buffer_count = pending_deletes.size();
         
         // Approximate memory calculations
-        stats.atom_list_bytes = atoms.size() * sizeof(Atom);
-        stats.index_map_bytes = atom_index.size() * (sizeof(OpID) + sizeof(AVLNode*) + 32) + atom_index.size() * sizeof(AVLNode); // Map + AVL nodes overhead
-        stats.orphan_buffer_bytes = total_orphan_count * sizeof(Atom);
+        stats.run_count = run_count;
+        stats.atom_list_bytes = chunk_count * sizeof(AtomChunk);
+        stats.index_map_bytes = run_index.memoryBytes() + run_count * (sizeof(uint64_t) + sizeof(AtomChunk*) + 32) +
+                                child_index.memoryBytes() + run_count * sizeof(OpID) +
+                                chunk_count * sizeof(AVLNode) + // Client table + run maps + child index + AVL nodes
+                                tombstone_index.memoryBytes();
+        stats.orphan_buffer_bytes = total_orphan_count * (sizeof(PendingOrphan) + sizeof(uint64_t) + sizeof(OrphanEntry) + 32);
         stats.vector_clock_bytes = vector_clock.getState().size() * 16;
+        for (const auto& entry : tombstone_index) stats.index_map_bytes += entry.second.size() * (sizeof(uint64_t) + 32);
+        for (const auto& entry : delete_log) stats.delete_op_count += entry.second.size();
+        stats.delete_log_bytes = delete_log.memoryBytes() + delete_log_stamps.memoryBytes() +
+                                 stats.delete_op_count * sizeof(DeleteOp);
         
         // Copy GC performance stats
         stats.gc_stats = gc_stats_;
+        stats.orphan_stats = orphan_stats_;
         
         return stats;
     }
@@ -654,105 +2403,390 @@ public:
         return total_orphan_count;
     }
 
+    /**
+     * @brief Returned by indexOf() for ids that are not in the document.
+     */
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    /**
+     * @brief Number of visible characters.
+     */
+    size_t length() const {
+        return root ? root->subtree_weight : 0;
+    }
+
+    /**
+     * @brief Visible index of an atom, in O(log n).
+     * For a tombstone this is the index the character had before it was
+     * deleted (the number of visible characters before it).
+     * @return The index, or npos if the id is unknown.
+     */
+    size_t indexOf(const OpID& id) const {
+        AtomPos pos = locate(id);
+        if (!pos.chunk) return npos;
+        return visibleIndex(pos);
+    }
+
+    /**
+     * @brief Id of the visible character at `literal_index`, in O(log n).
+     * @return The id, or {0,0} if the index is out of range.
+     */
+    OpID idAt(size_t literal_index) const {
+        if (literal_index >= length()) return {0, 0};
+        AtomPos pos = findByPrefixWeight(literal_index + 1);
+        return pos.chunk->idAt(pos.offset);
+    }
+
+    /**
+     * @brief Forward iterator over visible characters.
+     * Reads straight out of the chunks, skipping tombstones and fully
+     * deleted chunks without copying. Any edit invalidates it.
+     */
+    class const_iterator {
+        const AtomChunk* chunk = nullptr;
+        size_t offset = 0;
+
+        const_iterator(const AtomChunk* c, size_t o) : chunk(c), offset(o) {
+            settle();
+        }
+
+        // Advance to the first visible atom at or after the current slot
+        void settle() {
+            while (chunk) {
+                if (chunk->node && chunk->node->weight > 0) {
+                    while (offset < chunk->size && !chunk->visible(offset)) offset++;
+                    if (offset < chunk->size) return;
+                }
+                chunk = chunk->next;
+                offset = 0;
+            }
+        }
+
+        friend class BasicSequence;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() = default;
+
+        reference operator*() const { return chunk->content[offset]; }
+
+        /**
+         * @brief Id of the character under the iterator.
+         */
+        OpID id() const { return chunk->idAt(offset); }
+
+        const_iterator& operator++() {
+            offset++;
+            settle();
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return chunk == other.chunk && offset == other.offset;
+        }
+
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+    };
+
+    const_iterator begin() const {
+        return const_iterator(head, 0);
+    }
+
+    const_iterator end() const {
+        return const_iterator();
+    }
+
+    /**
+     * @brief Iterator at visible index `literal_index`, in O(log n).
+     * @return end() if the index is out of range.
+     */
+    const_iterator iteratorAt(size_t literal_index) const {
+        if (literal_index >= length()) return end();
+        AtomPos pos = findByPrefixWeight(literal_index + 1);
+        return const_iterator(pos.chunk, pos.offset);
+    }
+
+    /**
+     * @brief Copy of `len` visible characters starting at `literal_index`.
+     * Seeks in O(log n) and walks only the requested range, so reading a
+     * viewport does not materialize the whole document. The range is
+     * clipped to the end of the text.
+     */
+    std::string substring(size_t literal_index, size_t len) const {
+        static_assert(kIsText, "substring() is for text; use iteratorAt() for other element types");
+        std::string result;
+        size_t total = length();
+        if (literal_index >= total) return result;
+        len = std::min(len, total - literal_index);
+        result.reserve(len);
+        for (const_iterator it = iteratorAt(literal_index); result.size() < len; ++it) {
+            result += *it;
+        }
+        return result;
+    }
+
 
 private:
+    /**
+     * @brief Add an op record to the delete log, merging with its
+     * predecessor where possible.
+     * @return The parts of `op` that were not logged before.
+     */
+    std::vector<DeleteOp> logDeleteOp(DeleteOp op) {
+        std::vector<DeleteOp> fresh;
+        std::vector<DeleteOp>& log = delete_log[op.client_id];
+        auto it = std::upper_bound(log.begin(), log.end(), op.start_clock,
+                                   [](uint64_t t, const DeleteOp& r) { return t < r.start_clock; });
+        if (it != log.begin() && std::prev(it)->lastClock() >= op.start_clock) {
+            uint64_t seen = std::prev(it)->lastClock() - op.start_clock + 1;
+            if (seen >= op.target.length) return fresh;
+            op = op.slice(seen, op.target.length - seen);
+        }
+
+        while (op.target.length > 0) {
+            // Part before the next logged record
+            uint64_t gap = it == log.end() ? op.target.length
+                                           : std::min(op.target.length, it->start_clock - op.start_clock);
+            if (gap > 0) {
+                DeleteOp piece = op.slice(0, gap);
+                fresh.push_back(piece);
+                if (it != log.begin() && std::prev(it)->extendWith(piece)) {
+                    // Merged into the previous record
+                } else {
+                    it = log.insert(it, piece) + 1;
+                }
+            }
+            if (gap == op.target.length) break;
+
+            // Skip what the next record already covers
+            uint64_t covered = std::min(op.target.length, it->lastClock() - op.start_clock + 1);
+            op = op.slice(covered, op.target.length - covered);
+            ++it;
+        }
+        if (!fresh.empty()) delete_log_stamps[op.client_id] = ++edit_stamp;
+        return fresh;
+    }
+
+    /**
+     * @brief Drop logged delete ops with clocks at or below `limit(client)`.
+     */
+    template <typename Limit>
+    void pruneDeleteLog(Limit limit) {
+        std::vector<uint64_t> drained;
+        for (auto& [client_id, log] : delete_log) {
+            uint64_t bound = limit(client_id);
+            auto keep = std::upper_bound(log.begin(), log.end(), bound,
+                                         [](uint64_t t, const DeleteOp& op) { return t < op.lastClock(); });
+            if (keep != log.end() && keep->start_clock <= bound) {
+                *keep = keep->slice(bound - keep->start_clock + 1, keep->lastClock() - bound);
+                delete_log_stamps[client_id] = ++edit_stamp;
+            }
+            if (keep != log.begin()) {
+                log.erase(log.begin(), keep);
+                delete_log_stamps[client_id] = ++edit_stamp;
+            }
+            if (log.empty()) drained.push_back(client_id);
+        }
+        for (uint64_t client_id : drained) {
+            delete_log.erase(client_id);
+            delete_log_stamps.erase(client_id);
+        }
+    }
+
     void checkPendingOrphans(OpID just_inserted_id) {
-        if (pending_orphans.count(just_inserted_id)) {
-            std::vector<Atom> children = pending_orphans[just_inserted_id];
-            pending_orphans.erase(just_inserted_id);
+        auto it = pending_orphans.find(just_inserted_id);
+        if (it != pending_orphans.end()) {
+            std::vector<PendingOrphan> children = std::move(it->second);
+            pending_orphans.erase(it);
             total_orphan_count -= children.size();
+            for (const auto& child : children) orphan_queue.erase(child.seq);
             for(const auto& child : children) {
-                remoteMerge(child);
+                remoteMerge(child.atom);
             }
         }
     }
     
     /**
-     * @brief Actually remove tombstones from all data structures.
+     * @brief One GC pass over the tombstones with clock <= bound(client).
      */
-    void removeTombstones(const std::vector<OpID>& to_remove) {
-        for (const auto& id : to_remove) {
-            auto map_it = atom_index.find(id);
-            if (map_it != atom_index.end()) {
-                AVLNode* node = map_it->second;
-                auto list_it = node->atom_it;
-                atoms.erase(list_it);
-                
-                deleteNode(node);
-                atom_index.erase(map_it);
-                tombstone_count--;
+    template <typename Bound>
+    size_t collectGarbage(Bound bound, size_t max_items, uint64_t budget_us) {
+        std::chrono::steady_clock::time_point start;
+        if constexpr (Policy::kTimed) {
+            start = std::chrono::steady_clock::now();
+        } else {
+            budget_us = 0;
+        }
+
+        std::vector<OpID> to_remove = collectTombstones(
+            bound, max_items ? max_items : std::numeric_limits<size_t>::max());
+        size_t removed = removeTombstones(to_remove, start, budget_us);
+        pruneDeleteLog(bound);
+
+        // Record GC performance
+        uint64_t duration_us = 0;
+        if constexpr (Policy::kTimed) {
+            auto end = std::chrono::steady_clock::now();
+            duration_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        }
+        gc_stats_.recordGCRun(duration_us, removed);
+
+        return removed;
+    }
+
+    /**
+     * @brief True when auto-GC is on and the tombstone threshold is reached.
+     * Always false, and compiled out of every edit, under NoAutoGC.
+     */
+    bool autoGCDue() const {
+        if constexpr (Policy::kAutoGC) {
+            return gc_config.auto_gc_enabled && tombstone_count >= gc_config.tombstone_threshold;
+        } else {
+            return false;
+        }
+    }
+
+    /**
+     * @brief Auto-GC, bounded by the per-edit limits in the GC config.
+     */
+    size_t autoCollect() {
+        return garbageCollectLocalStep(gc_config.min_age_threshold, gc_config.max_items_per_step,
+                                       gc_config.max_pause_us);
+    }
+
+    /**
+     * @brief Actually remove tombstones from all data structures, stopping
+     * once `budget_us` has passed since `start` (0 = no budget).
+     * @return Number of tombstones removed
+     */
+    size_t removeTombstones(const std::vector<OpID>& to_remove,
+                            std::chrono::steady_clock::time_point start, uint64_t budget_us) {
+        size_t removed = 0;
+        for (size_t i = 0; i < to_remove.size(); i++) {
+            if (budget_us && i % 16 == 15 &&
+                std::chrono::steady_clock::now() - start >= std::chrono::microseconds(budget_us)) {
+                break;
             }
+            const OpID& id = to_remove[i];
+            AtomPos pos = locate(id);
+            if (!pos.chunk) continue;  // Already gone; not work done
+            eraseAtom(pos);
+            unindexTombstone(id);
+            tombstone_count--;
+            removed++;
         }
+        return removed;
     }
     
     /**
-     * @brief Determine if an orphan should be accepted into the buffer.
+     * @brief Drop the orphan that has waited longest, O(log n).
+     */
+    void dropOldestOrphan() {
+        auto oldest = orphan_queue.begin();
+        auto it = pending_orphans.find(oldest->second.origin);
+        std::vector<PendingOrphan>& children = it->second;
+        auto child = std::find_if(children.begin(), children.end(),
+            [&](const PendingOrphan& c) { return c.seq == oldest->first; });
+        children.erase(child);
+        if (children.empty()) pending_orphans.erase(it);
+        orphan_queue.erase(oldest);
+        total_orphan_count--;
+    }
+
+    /**
+     * @brief Drop orphans that have waited more than max_orphan_age ticks
+     * of the local clock. Arrival order is clock order, so only the front
+     * of the queue is checked. Runs on every edit and received batch, so
+     * a buffer that stops growing still ages out.
      */
-    bool shouldAcceptOrphan(const Atom& atom) const {
+    void expireOrphans() {
+        if constexpr (!Policy::kBufferOutOfOrder) return;
         uint64_t current_time = clock.peek();
-        if (atom.id.clock < current_time && 
-            (current_time - atom.id.clock) > orphan_config.max_orphan_age) {
-            return false;
+        while (!orphan_queue.empty() &&
+               current_time - orphan_queue.begin()->second.buffered_at > orphan_config.max_orphan_age) {
+            dropOldestOrphan();
+            orphan_stats_.expired++;
         }
-        return true;
     }
-    
+
     /**
-     * @brief Evict old orphans when buffer is full.
+     * @brief Make room in a full buffer by dropping the oldest tenth of it.
      */
     void evictOldOrphans() {
-        if (pending_orphans.empty()) return;
-        
-        std::vector<std::pair<uint64_t, OpID>> orphan_ages;
-        for (const auto& [parent_id, children] : pending_orphans) {
-            for (const auto& orphan : children) {
-                orphan_ages.push_back({orphan.id.clock, parent_id});
-            }
+        size_t to_evict = std::max(size_t(1), total_orphan_count / 10);
+        for (size_t i = 0; i < to_evict && !orphan_queue.empty(); i++) {
+            dropOldestOrphan();
+            orphan_stats_.evicted++;
         }
-        
-        std::sort(orphan_ages.begin(), orphan_ages.end());
-        
-        size_t to_evict = std::max(size_t(1), orphan_ages.size() / 10);
-        
-        for (size_t i = 0; i < to_evict && i < orphan_ages.size(); i++) {
-            OpID parent_id = orphan_ages[i].second;
-            if (pending_orphans.count(parent_id) && !pending_orphans[parent_id].empty()) {
-                auto& children = pending_orphans[parent_id];
-                
-                auto oldest_it = std::min_element(children.begin(), children.end(),
-                    [](const Atom& a, const Atom& b) { return a.id.clock < b.id.clock; });
-                
-                if (oldest_it != children.end()) {
-                    children.erase(oldest_it);
-                    total_orphan_count--;
-                    
-                    if (children.empty()) {
-                        pending_orphans.erase(parent_id);
-                    }
+    }
+
+public:
+    /**
+     * @brief Visible text, kept materialized between reads.
+     *
+     * The first read builds the string. After that, edits queue small
+     * patches (typing and backspacing runs fold into one) that the next
+     * read splices in, so reading an unchanged document is O(1). Large or
+     * scattered changes drop the cache and the next read rebuilds it.
+     * Positions match length(), indexOf() and idAt(). The cache is built
+     * under a lock, so threads may read concurrently while nobody edits.
+     */
+    const std::string& text() const {
+        static_assert(kIsText, "text() is for text; use begin() and end() for other element types");
+        std::lock_guard<std::mutex> lock(text_mutex);
+        if (!text_cache_valid) {
+            text_cache.clear();
+            text_cache.reserve(length());
+            for (const AtomChunk* chunk = head; chunk; chunk = chunk->next) {
+                for (size_t i = 0; i < chunk->size; i++) {
+                    if (chunk->visible(i)) text_cache += chunk->content[i];
                 }
             }
+            text_cache_valid = true;
+        } else {
+            for (const TextPatch& patch : text_patches) {
+                text_cache.replace(patch.index, patch.erase, patch.insert);
+            }
         }
+        text_patches.clear();
+        return text_cache;
     }
 
-public:
     std::string toString() const {
-        std::string result = "";
-        for (const auto& a : atoms) {
-            if (!a.is_deleted && a.content != 0) {
-                result += a.content;
-            }
+        std::string result = text();
+        if (result.find('\0') != std::string::npos) {
+            result.erase(std::remove(result.begin(), result.end(), '\0'), result.end());
         }
         return result;
     }
 
     /**
      * @brief SAVE TO STREAM (Binary format)
-     * Format: [MAGIC: "OMNI"] [VER: 2] [CLIENT_ID: 8b] [CLOCK: 8b] [VCLOCK] [COUNT: 8b] [ATOMS...]
+     * Format: [MAGIC: "OMNI"] [VER] [CLIENT_ID: 8b] [CLOCK: 8b] [VCLOCK] [BODY]
+     *
+     * Version 3 (default) stores the body as LEB128 columns, see writeColumns().
+     * Version 2 stores [COUNT: 8b] and 34-byte atom records, for older readers;
+     * it does not keep the delete log, so a replica loaded from it relays
+     * deletes as tombstones only. It holds text only; other element types
+     * always write version 3.
      */
-    void save(std::ostream& out) const {
+    void save(std::ostream& out, uint8_t version = 3) const {
         // Header
         out.write("OMNI", 4);
-        uint8_t ver = 2; // Version bump for vector clock
+        uint8_t ver = version == 2 && kIsText ? 2 : 3;
         out.write((char*)&ver, 1);
         
         // Metadata
@@ -763,19 +2797,131 @@ public:
         // Vector Clock
         vector_clock.save(out);
 
+        if (ver == 3) {
+            std::vector<uint8_t> body;
+            writeColumns(body);
+            uint64_t body_size = body.size();
+            out.write((char*)&body_size, sizeof(body_size));
+            out.write((const char*)body.data(), body.size());
+            return;
+        }
+
         // Data
-        uint64_t count = atoms.size();
+        uint64_t count = atom_count;
         out.write((char*)&count, sizeof(count));
 
-        for (const auto& atom : atoms) {
-            out.write((char*)&atom.id.client_id, 8);
-            out.write((char*)&atom.id.clock, 8);
-            out.write((char*)&atom.origin.client_id, 8);
-            out.write((char*)&atom.origin.clock, 8);
-            out.write(&atom.content, 1);
-            uint8_t del = atom.is_deleted ? 1 : 0;
-            out.write((char*)&del, 1);
+        for (const AtomChunk* chunk = head; chunk; chunk = chunk->next) {
+            for (size_t i = 0; i < chunk->size; i++) {
+                Atom atom = chunk->atomAt(i);
+                out.write((char*)&atom.id.client_id, 8);
+                out.write((char*)&atom.id.clock, 8);
+                out.write((char*)&atom.origin.client_id, 8);
+                out.write((char*)&atom.origin.clock, 8);
+                if constexpr (kIsText) out.write(&atom.content, 1);
+                uint8_t del = atom.is_deleted ? 1 : 0;
+                out.write((char*)&del, 1);
+            }
+        }
+    }
+
+    /**
+     * @brief SAVE AS A MAPPABLE SNAPSHOT
+     * Fixed-width columns that SnapshotView serves without parsing, plus
+     * the delete log so a promoted copy can relay deletes; see
+     * SnapshotLayout for the format.
+     */
+    void saveSnapshot(std::ostream& out) const {
+        static_assert(kIsText, "Mapped snapshots hold text only");
+        const auto& vclock = vector_clock.getState();
+        size_t delete_ops = 0;
+        for (const auto& entry : delete_log) delete_ops += entry.second.size();
+        SnapshotLayout layout(atom_count, vclock.size(), delete_ops);
+
+        std::vector<uint64_t> header = {my_client_id, clock.peek(), atom_count, length(), vclock.size()};
+        for (const auto& [id, time] : vclock) {
+            header.push_back(id);
+            header.push_back(time);
+        }
+
+        std::vector<uint64_t> id_client, id_clock, origin_client, origin_clock;
+        id_client.reserve(atom_count);
+        id_clock.reserve(atom_count);
+        origin_client.reserve(atom_count);
+        origin_clock.reserve(atom_count);
+        std::string content;
+        content.reserve(layout.deleted - layout.content);
+        std::vector<uint64_t> deleted(layout.blocks, 0);
+        std::vector<uint64_t> weights(layout.blocks + 1, 0);
+
+        size_t i = 0;
+        for (const AtomChunk* chunk = head; chunk; chunk = chunk->next) {
+            size_t offset = 0;
+            for (size_t r = 0; r < chunk->run_count; r++) {
+                const AtomRun& run = chunk->runs[r];
+                for (size_t j = 0; j < run.length; j++, offset++, i++) {
+                    OpID id = run.idAt(j);
+                    OpID origin = run.originAt(j);
+                    id_client.push_back(id.client_id);
+                    id_clock.push_back(id.clock);
+                    origin_client.push_back(origin.client_id);
+                    origin_clock.push_back(origin.clock);
+                    content += chunk->content[offset];
+                    if (chunk->deleted[offset]) deleted[i / 64] |= uint64_t(1) << (i % 64);
+                    if (chunk->visible(offset)) weights[i / 64 + 1]++;
+                }
+            }
+        }
+        for (size_t b = 1; b <= layout.blocks; b++) weights[b] += weights[b - 1];
+        content.resize(layout.deleted - layout.content, '\0');
+
+        auto writeWords = [&out](const std::vector<uint64_t>& words) {
+            out.write(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(uint64_t));
+        };
+        out.write(SnapshotLayout::kMagic, 4);
+        const char version[4] = {static_cast<char>(SnapshotLayout::kVersion), 0, 0, 0};
+        out.write(version, 4);
+        writeWords(header);
+        writeWords(id_client);
+        writeWords(id_clock);
+        writeWords(origin_client);
+        writeWords(origin_clock);
+        out.write(content.data(), content.size());
+        writeWords(deleted);
+        writeWords(weights);
+
+        std::vector<uint64_t> log_words = {delete_ops};
+        log_words.reserve(1 + delete_ops * 6);
+        for (const auto& [client_id, log] : delete_log) {
+            for (const DeleteOp& op : log) {
+                log_words.insert(log_words.end(), {op.client_id, op.start_clock, op.target.client_id,
+                                                   op.target.start_clock, op.target.step, op.target.length});
+            }
+        }
+        writeWords(log_words);
+    }
+
+    /**
+     * @brief LOAD FROM A MAPPED SNAPSHOT
+     * Clears current state and rebuilds from the view, delete log
+     * included, like load(std::istream&).
+     */
+    bool load(const SnapshotView& view) {
+        static_assert(kIsText, "Mapped snapshots hold text only");
+        if (!view.valid()) return false;
+        resetForLoad();
+
+        my_client_id = view.clientId();
+        clock.merge(view.clock());
+        vector_clock.assign(view.vectorClock());
+
+        for (size_t i = 0; i < view.atomCount(); i++) {
+            Atom a = view.atomAt(i);
+            appendAtomUnindexed(a);
+            if (a.is_deleted) tombstone_count++;
         }
+        buildIndex();
+        for (size_t i = 0; i < view.deleteOpCount(); i++) logDeleteOp(view.deleteOpAt(i));
+        return true;
     }
 
     /**
@@ -789,66 +2935,77 @@ public:
 
         uint8_t ver;
         in.read((char*)&ver, 1);
-        if (ver != 1 && ver != 2) return false; // Support both versions
+        if (ver < 1 || ver > 3) return false; // Support all versions
+        if (!kIsText && ver < 3) return false; // Fixed records hold one char
 
-        atoms.clear();
-        atom_index.clear();
-        pending_orphans.clear();
-        pending_deletes.clear();
-        
-        destroyTree(root);
-        root = nullptr;
-        tombstone_count = 0;
-        total_orphan_count = 0;
+        resetForLoad();
 
         in.read((char*)&my_client_id, sizeof(my_client_id));
         uint64_t clock_val;
         in.read((char*)&clock_val, sizeof(clock_val));
         clock.merge(clock_val);
         
-        // Load vector clock if version 2
-        if (ver == 2) {
+        // Load vector clock if version 2+
+        if (ver >= 2) {
             vector_clock.load(in);
         }
 
+        if (ver == 3) {
+            uint64_t body_size = 0;
+            in.read((char*)&body_size, sizeof(body_size));
+            std::vector<uint8_t> body;
+            // Grow as data arrives so a corrupt size cannot force a huge allocation
+            while (in && body.size() < body_size) {
+                size_t piece = static_cast<size_t>(std::min<uint64_t>(body_size - body.size(), 1 << 20));
+                size_t old_size = body.size();
+                body.resize(old_size + piece);
+                in.read((char*)body.data() + old_size, piece);
+            }
+            if (in && readColumns(body)) return true;
+
+            // Leave an empty, usable document behind
+            resetForLoad();
+            appendAtomUnindexed(Atom({0, 0}, {0, 0}, T()));
+            buildIndex();
+            return false;
+        }
+
         uint64_t count;
         in.read((char*)&count, sizeof(count));
 
-        for (uint64_t i = 0; i < count; i++) {
-            Atom a;
-            in.read((char*)&a.id.client_id, 8);
-            in.read((char*)&a.id.clock, 8);
-            in.read((char*)&a.origin.client_id, 8);
-            in.read((char*)&a.origin.clock, 8);
-            in.read(&a.content, 1);
-            uint8_t del;
-            in.read((char*)&del, 1);
-            a.is_deleted = (del == 1);
-
-            atoms.push_back(a);
-            
-            auto last_it = std::prev(atoms.end());
-            
-            size_t weight = a.is_deleted ? 0 : 1;
-            if (a.id.client_id == 0 && a.id.clock == 0) weight = 0;
-            
-            AVLNode* new_node = new AVLNode(a.id, last_it, weight);
-            atom_index[a.id] = new_node;
-            
-            if (a.is_deleted) tombstone_count++;
-
-            if (i == 0) {
-                root = new_node;
-            } else {
-                auto prev_it = std::prev(last_it);
-                AVLNode* prev_node = atom_index[prev_it->id];
-                insertNode(prev_node, new_node);
+        // Atoms are fixed-size records; read them a block at a time
+        constexpr size_t kRecordSize = 34;
+        constexpr uint64_t kBlockAtoms = 4096;
+        std::vector<char> block;
+        for (uint64_t done = 0; done < count;) {
+            uint64_t n = std::min(count - done, kBlockAtoms);
+            block.resize(n * kRecordSize);
+            in.read(block.data(), block.size());
+            const char* end = block.data() + (static_cast<size_t>(in.gcount()) / kRecordSize) * kRecordSize;
+
+            for (const char* rec = block.data(); rec != end; rec += kRecordSize) {
+                Atom a;
+                std::memcpy(&a.id.client_id, rec, 8);
+                std::memcpy(&a.id.clock, rec + 8, 8);
+                std::memcpy(&a.origin.client_id, rec + 16, 8);
+                std::memcpy(&a.origin.clock, rec + 24, 8);
+                if constexpr (kIsText) a.content = rec[32];
+                a.is_deleted = (rec[33] == 1);
+
+                appendAtomUnindexed(a);
+                
+                if (a.is_deleted) tombstone_count++;
             }
+            if (!in) break;  // Keep the whole records read so far
+            done += n;
         }
+        buildIndex();
 
-        return true;
+        return static_cast<bool>(in);  // False if the atom data was truncated
     }
 };
 
+using Sequence = BasicSequence<>;
+
 } // namespace core
 } // namespace omnisync
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "lamport_clock.hpp"
+
+namespace omnisync {
+namespace core {
+
+/**
+ * @brief Compile-time feature set of a BasicSequence.
+ *
+ * The defaults are the general-purpose replica: ops may arrive out of
+ * causal order, auto-GC can be switched on at runtime, GC and delta
+ * batches are timed, and the Lamport clock is atomic.
+ *
+ * Features are turned off by wrapping the policy in the options below.
+ * Each one overrides a single member and keeps the rest of its base:
+ *
+ *   using ServerPolicy = CausalInput<NoAutoGC<SingleThreadClock<>>>;
+ *   BasicSequence<char, std::allocator<char>, ServerPolicy> replica(1);
+ */
+struct DefaultSequencePolicy {
+    // Buffer inserts whose origin and deletes whose target haven't arrived
+    static constexpr bool kBufferOutOfOrder = true;
+
+    // Check GCConfig::auto_gc_enabled after every edit
+    static constexpr bool kAutoGC = true;
+
+    // Read the clock for GCStats, DeltaStats::apply_time_us and GC time budgets
+    static constexpr bool kTimed = true;
+
+    // Lamport clock type (peek/tick/merge)
+    using Clock = LamportClock;
+};
+
+/**
+ * @brief Input arrives in causal order (e.g. from a single upstream relay).
+ *
+ * The orphan and delete buffers are compiled out. An insert whose origin
+ * is missing, or a delete whose target is missing, is dropped.
+ */
+template <typename Base = DefaultSequencePolicy>
+struct CausalInput : Base {
+    static constexpr bool kBufferOutOfOrder = false;
+};
+
+/**
+ * @brief No auto-GC: edits never check the tombstone threshold.
+ * GCConfig::auto_gc_enabled is ignored; call garbageCollect*() explicitly.
+ */
+template <typename Base = DefaultSequencePolicy>
+struct NoAutoGC : Base {
+    static constexpr bool kAutoGC = false;
+};
+
+/**
+ * @brief No clock reads in GC or applyDelta.
+ * Recorded durations are 0 and time budgets are ignored (item budgets still apply).
+ */
+template <typename Base = DefaultSequencePolicy>
+struct NoTiming : Base {
+    static constexpr bool kTimed = false;
+};
+
+/**
+ * @brief Plain Lamport clock for documents owned by one thread.
+ */
+template <typename Base = DefaultSequencePolicy>
+struct SingleThreadClock : Base {
+    using Clock = PlainLamportClock;
+};
+
+} // namespace core
+} // namespace omnisync
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace omnisync {
+namespace core {
+
+/**
+ * @brief Fixed-size object pool backed by geometrically growing slabs.
+ *
+ * Objects are carved out of large slabs obtained from `Allocator` and
+ * recycled through an intrusive free list, so steady-state create/destroy
+ * never touches the global heap. Because the pooled types are trivially
+ * destructible, `release()` drops every object at once by handing the
+ * slabs back, without visiting the objects. It is O(number of slabs):
+ * logarithmic while slabs double, then one slab per kMaxSlabSlots
+ * objects, so a pool of n objects frees about n / 4096 blocks. The cap
+ * bounds the unused tail of the newest slab.
+ *
+ * @tparam T Pooled type (must be trivially destructible)
+ * @tparam Allocator Any standard allocator; it is rebound to slab storage.
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class SlabPool {
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "SlabPool releases slabs without running destructors");
+
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    using SlotAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+    using SlotTraits = std::allocator_traits<SlotAllocator>;
+
+    static constexpr size_t kFirstSlabSlots = 8;
+    static constexpr size_t kMaxSlabSlots = 4096;  // Slabs stop doubling here
+
+    SlotAllocator allocator_;
+    std::vector<std::pair<Slot*, size_t>> slabs_;  // (storage, slot count)
+    Slot* free_list_ = nullptr;
+    Slot* bump_ = nullptr;       // Next untouched slot in the newest slab
+    Slot* bump_end_ = nullptr;
+    size_t live_ = 0;
+
+    void grow() {
+        size_t slots = slabs_.empty() ? kFirstSlabSlots
+                                      : std::min(slabs_.back().second * 2, kMaxSlabSlots);
+        Slot* slab = SlotTraits::allocate(allocator_, slots);
+        slabs_.emplace_back(slab, slots);
+        bump_ = slab;
+        bump_end_ = slab + slots;
+    }
+
+public:
+    explicit SlabPool(const Allocator& alloc = Allocator()) : allocator_(alloc) {}
+
+    ~SlabPool() {
+        release();
+    }
+
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    SlabPool(SlabPool&& other) noexcept
+        : allocator_(std::move(other.allocator_)),
+          slabs_(std::move(other.slabs_)),
+          free_list_(other.free_list_),
+          bump_(other.bump_),
+          bump_end_(other.bump_end_),
+          live_(other.live_) {
+        other.slabs_.clear();
+        other.free_list_ = other.bump_ = other.bump_end_ = nullptr;
+        other.live_ = 0;
+    }
+
+    SlabPool& operator=(SlabPool&& other) noexcept {
+        if (this != &other) {
+            release();
+            allocator_ = std::move(other.allocator_);
+            slabs_ = std::move(other.slabs_);
+            free_list_ = other.free_list_;
+            bump_ = other.bump_;
+            bump_end_ = other.bump_end_;
+            live_ = other.live_;
+            other.slabs_.clear();
+            other.free_list_ = other.bump_ = other.bump_end_ = nullptr;
+            other.live_ = 0;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Construct a T in pooled storage.
+     */
+    template <typename... Args>
+    T* create(Args&&... args) {
+        Slot* slot = free_list_;
+        if (slot) {
+            free_list_ = slot->next;
+        } else {
+            if (bump_ == bump_end_) grow();
+            slot = bump_++;
+        }
+        live_++;
+        return ::new (static_cast<void*>(slot->storage)) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Return a single object to the free list.
+     */
+    void destroy(T* object) {
+        if (!object) return;
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        slot->next = free_list_;
+        free_list_ = slot;
+        live_--;
+    }
+
+    /**
+     * @brief Drop every object and give all slabs back to the allocator.
+     */
+    void release() {
+        for (const auto& [slab, slots] : slabs_) {
+            SlotTraits::deallocate(allocator_, slab, slots);
+        }
+        slabs_.clear();
+        free_list_ = bump_ = bump_end_ = nullptr;
+        live_ = 0;
+    }
+
+    /**
+     * @brief Number of objects currently handed out.
+     */
+    size_t size() const {
+        return live_;
+    }
+
+    /**
+     * @brief Bytes reserved from the allocator (live + free slots).
+     */
+    size_t reservedBytes() const {
+        size_t bytes = 0;
+        for (const auto& slab : slabs_) bytes += slab.second * sizeof(Slot);
+        return bytes;
+    }
+};
+
+} // namespace core
+} // namespace omnisync
@@ -0,0 +1,408 @@
+#ifndef OMNISYNC_CORE_SNAPSHOT_VIEW_HPP
+#define OMNISYNC_CORE_SNAPSHOT_VIEW_HPP
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+    #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "crdt_atom.hpp"
+#include "vector_clock.hpp"
+
+namespace omnisync::core {
+
+/**
+ * @brief Byte layout of a mapped ("OMNM") snapshot.
+ *
+ * Every field is a host-order uint64_t at an 8-byte aligned offset, so the
+ * file can be served straight from an mmap without parsing:
+ *
+ *   [MAGIC: "OMNM"] [VER: 2] [PAD: 3]
+ *   [CLIENT_ID] [CLOCK] [ATOM_COUNT: n] [VISIBLE_COUNT] [VCLOCK_COUNT: v]
+ *   [VCLOCK: v x (client, time)]
+ *   [ID_CLIENT: n] [ID_CLOCK: n] [ORIGIN_CLIENT: n] [ORIGIN_CLOCK: n]
+ *   [CONTENT: n bytes, padded to 8]
+ *   [DELETED: one bit per atom, (n + 63) / 64 words]
+ *   [WEIGHTS: visible atoms before each 64-atom block, (n + 63) / 64 + 1 words]
+ *   [DELETE_OP_COUNT: d]
+ *   [DELETE_OPS: d x (client, clock, target client, target clock, step, length)]
+ *
+ * Atoms are in document order, the start node first. The delete ops are
+ * the document's delete log, so a replica promoted from the snapshot can
+ * still relay deletes. Version 1 files end after WEIGHTS.
+ */
+struct SnapshotLayout {
+    static constexpr char kMagic[4] = {'O', 'M', 'N', 'M'};
+    static constexpr uint8_t kVersion = 2;
+    static constexpr size_t kHeaderSize = 48;
+    static constexpr size_t kDeleteOpSize = 48;
+
+    size_t atom_count = 0;
+    size_t vclock_count = 0;
+    size_t delete_op_count = 0;
+    size_t blocks = 0;
+
+    size_t vclock = 0;
+    size_t id_client = 0;
+    size_t id_clock = 0;
+    size_t origin_client = 0;
+    size_t origin_clock = 0;
+    size_t content = 0;
+    size_t deleted = 0;
+    size_t weights = 0;
+    size_t delete_count = 0;  // Offset of DELETE_OP_COUNT (the end of a version 1 file)
+    size_t delete_ops = 0;
+    size_t total = 0;
+
+    SnapshotLayout(size_t atoms, size_t vclocks, size_t deletes = 0, uint8_t version = kVersion)
+        : atom_count(atoms), vclock_count(vclocks), delete_op_count(deletes) {
+        blocks = (atoms + 63) / 64;
+        vclock = kHeaderSize;
+        id_client = vclock + vclocks * 16;
+        id_clock = id_client + atoms * 8;
+        origin_client = id_clock + atoms * 8;
+        origin_clock = origin_client + atoms * 8;
+        content = origin_clock + atoms * 8;
+        deleted = content + (atoms + 7) / 8 * 8;
+        weights = deleted + blocks * 8;
+        delete_count = weights + (blocks + 1) * 8;
+        delete_ops = delete_count + 8;
+        total = version >= 2 ? delete_ops + deletes * kDeleteOpSize : delete_count;
+    }
+
+    /**
+     * @brief Upper bound on atom_count for a file of `size` bytes, so that
+     * computing the layout cannot overflow.
+     */
+    static size_t maxAtoms(size_t size) {
+        return size / 33;
+    }
+};
+
+/**
+ * @brief Read-only view of a mapped snapshot.
+ *
+ * Answers text and position queries straight from the mapped bytes:
+ * length() is O(1), idAt() and substring() seek in O(log n) through the
+ * per-block weights. Nothing is copied until a caller asks for text.
+ * The view does not own the bytes; keep the mapping alive while using it.
+ */
+class SnapshotView {
+public:
+    SnapshotView() : layout_(0, 0) {}
+
+    /**
+     * @brief Attach to `size` bytes at `data`.
+     * @return false if the bytes are not a complete, well-formed snapshot
+     */
+    bool open(const void* data, size_t size) {
+        data_ = nullptr;
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        if (!bytes || size < SnapshotLayout::kHeaderSize) return false;
+        if (std::memcmp(bytes, SnapshotLayout::kMagic, 4) != 0) return false;
+        uint8_t version = bytes[4];
+        if (version < 1 || version > SnapshotLayout::kVersion) return false;
+
+        uint64_t atoms = word(bytes, 24);
+        uint64_t vclocks = word(bytes, 40);
+        if (atoms > SnapshotLayout::maxAtoms(size) || vclocks > size / 16) return false;
+
+        SnapshotLayout layout(static_cast<size_t>(atoms), static_cast<size_t>(vclocks), 0, version);
+        if (version >= 2) {
+            if (layout.delete_ops > size) return false;
+            uint64_t deletes = word(bytes, layout.delete_count);
+            if (deletes > (size - layout.delete_ops) / SnapshotLayout::kDeleteOpSize) return false;
+            layout = SnapshotLayout(layout.atom_count, layout.vclock_count, static_cast<size_t>(deletes), version);
+        }
+        if (layout.total != size) return false;
+        for (size_t i = 0; i < layout.delete_op_count; i++) {
+            size_t at = layout.delete_ops + i * SnapshotLayout::kDeleteOpSize;
+            uint64_t start = word(bytes, at + 8), step = word(bytes, at + 32), length = word(bytes, at + 40);
+            if (step == 0 || length == 0 || start > UINT64_MAX - length) return false;
+        }
+
+        // Weights must agree with the deleted bitmap, or seeks could run off the end
+        uint64_t visible = 0;
+        for (size_t b = 0; b < layout.blocks; b++) {
+            if (word(bytes, layout.weights + b * 8) != visible) return false;
+            visible += visibleInBlock(bytes, layout, b);
+        }
+        if (word(bytes, layout.weights + layout.blocks * 8) != visible) return false;
+        if (word(bytes, 32) != visible) return false;
+
+        data_ = bytes;
+        layout_ = layout;
+        return true;
+    }
+
+    bool valid() const { return data_ != nullptr; }
+
+    uint64_t clientId() const { return word(data_, 8); }
+    uint64_t clock() const { return word(data_, 16); }
+    size_t atomCount() const { return layout_.atom_count; }
+
+    /**
+     * @brief Number of visible characters.
+     */
+    size_t length() const {
+        return valid() ? static_cast<size_t>(word(data_, 32)) : 0;
+    }
+
+    VectorClock vectorClock() const {
+        VectorClock vc;
+        for (size_t i = 0; i < layout_.vclock_count; i++) {
+            vc.update(word(data_, layout_.vclock + i * 16), word(data_, layout_.vclock + i * 16 + 8));
+        }
+        return vc;
+    }
+
+    /**
+     * @brief Number of delete-log records (0 for version 1 files).
+     */
+    size_t deleteOpCount() const {
+        return layout_.delete_op_count;
+    }
+
+    /**
+     * @brief The i-th delete-log record. Records are grouped by client, in clock order.
+     */
+    DeleteOp deleteOpAt(size_t i) const {
+        size_t at = layout_.delete_ops + i * SnapshotLayout::kDeleteOpSize;
+        DeleteOp op;
+        op.client_id = word(data_, at);
+        op.start_clock = word(data_, at + 8);
+        op.target.client_id = word(data_, at + 16);
+        op.target.start_clock = word(data_, at + 24);
+        op.target.step = word(data_, at + 32);
+        op.target.length = word(data_, at + 40);
+        return op;
+    }
+
+    /**
+     * @brief The i-th atom in document order, tombstones included.
+     */
+    Atom atomAt(size_t i) const {
+        Atom atom;
+        atom.id = {word(data_, layout_.id_client + i * 8), word(data_, layout_.id_clock + i * 8)};
+        atom.origin = {word(data_, layout_.origin_client + i * 8), word(data_, layout_.origin_clock + i * 8)};
+        atom.content = static_cast<char>(data_[layout_.content + i]);
+        atom.is_deleted = deleted(i);
+        return atom;
+    }
+
+    /**
+     * @brief Id of the visible character at `literal_index`, {0, 0} if out of range.
+     */
+    OpID idAt(size_t literal_index) const {
+        if (literal_index >= length()) return {0, 0};
+        size_t i = atomOfVisible(literal_index);
+        return {word(data_, layout_.id_client + i * 8), word(data_, layout_.id_clock + i * 8)};
+    }
+
+    /**
+     * @brief Copy of `len` visible characters starting at `literal_index`,
+     * clipped to the end of the text.
+     */
+    std::string substring(size_t literal_index, size_t len) const {
+        std::string result;
+        size_t total = length();
+        if (literal_index >= total) return result;
+        len = std::min(len, total - literal_index);
+        result.reserve(len);
+        for (size_t i = atomOfVisible(literal_index); result.size() < len; i++) {
+            if (visible(i)) result += static_cast<char>(data_[layout_.content + i]);
+        }
+        return result;
+    }
+
+    /**
+     * @brief All visible characters (same as Sequence::text()).
+     */
+    std::string text() const {
+        return substring(0, length());
+    }
+
+    /**
+     * @brief Visible text with NUL characters removed (same as Sequence::toString()).
+     */
+    std::string toString() const {
+        std::string result = text();
+        result.erase(std::remove(result.begin(), result.end(), '\0'), result.end());
+        return result;
+    }
+
+private:
+    const uint8_t* data_ = nullptr;
+    SnapshotLayout layout_;
+
+    static uint64_t word(const uint8_t* bytes, size_t offset) {
+        uint64_t value;
+        std::memcpy(&value, bytes + offset, sizeof(value));
+        return value;
+    }
+
+    /**
+     * @brief Visibility bits of block `b`: not deleted and not the start node.
+     */
+    static uint64_t visibleBits(const uint8_t* bytes, const SnapshotLayout& layout, size_t b) {
+        uint64_t bits = ~word(bytes, layout.deleted + b * 8);
+        if (b == 0) bits &= ~uint64_t(1);
+        size_t in_block = std::min<size_t>(64, layout.atom_count - b * 64);
+        if (in_block < 64) bits &= (uint64_t(1) << in_block) - 1;
+        return bits;
+    }
+
+    static uint64_t visibleInBlock(const uint8_t* bytes, const SnapshotLayout& layout, size_t b) {
+        uint64_t bits = visibleBits(bytes, layout, b);
+        uint64_t count = 0;
+        for (; bits; bits &= bits - 1) count++;
+        return count;
+    }
+
+    bool deleted(size_t i) const {
+        return (word(data_, layout_.deleted + i / 64 * 8) >> (i % 64)) & 1;
+    }
+
+    bool visible(size_t i) const {
+        return (visibleBits(data_, layout_, i / 64) >> (i % 64)) & 1;
+    }
+
+    /**
+     * @brief Atom index of the visible character at `literal_index` (< length()).
+     */
+    size_t atomOfVisible(size_t literal_index) const {
+        // Last block whose prefix weight is <= literal_index
+        size_t lo = 0, hi = layout_.blocks;
+        while (hi - lo > 1) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (word(data_, layout_.weights + mid * 8) <= literal_index) lo = mid;
+            else hi = mid;
+        }
+        size_t rank = literal_index - static_cast<size_t>(word(data_, layout_.weights + lo * 8));
+        uint64_t bits = visibleBits(data_, layout_, lo);
+        for (; rank > 0; rank--) bits &= bits - 1;
+        size_t bit = 0;
+        while (!((bits >> bit) & 1)) bit++;
+        return lo * 64 + bit;
+    }
+};
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : data_(other.data_), size_(other.size_)
+#ifdef _WIN32
+        , mapping_(other.mapping_)
+#endif
+    {
+        other.data_ = nullptr;
+        other.size_ = 0;
+#ifdef _WIN32
+        other.mapping_ = nullptr;
+#endif
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+#ifdef _WIN32
+            std::swap(mapping_, other.mapping_);
+#endif
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Map `path` read-only. Empty or missing files fail.
+     */
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+        mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping_) return false;
+        void* view = MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+        if (!view) {
+            CloseHandle(mapping_);
+            mapping_ = nullptr;
+            return false;
+        }
+        data_ = static_cast<const uint8_t*>(view);
+        size_ = static_cast<size_t>(file_size.QuadPart);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+        void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);  // The mapping keeps the file alive
+        if (view == MAP_FAILED) return false;
+        data_ = static_cast<const uint8_t*>(view);
+        size_ = static_cast<size_t>(st.st_size);
+#endif
+        return true;
+    }
+
+    void close() {
+        if (!data_) return;
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+#else
+        munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    HANDLE mapping_ = nullptr;
+#endif
+};
+
+} // namespace omnisync::core
+
+#endif // OMNISYNC_CORE_SNAPSHOT_VIEW_HPP
@@ -171,6 +171,13 @@ public:
         return result;
     }
 
+    /**
+     * @brief Replace every entry with `other`'s, keeping this clock's owner.
+     */
+    void assign(const VectorClock& other) {
+        clock = other.clock;
+    }
+
     /**
      * @brief Serialize to binary stream.
      */
@@ -0,0 +1,520 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "sequence.hpp"
+#include "epoch.hpp"
+
+namespace omnisync {
+namespace core {
+
+/**
+ * @brief Immutable, read-only copy of a document at one point in time.
+ *
+ * A version holds a copy of each rope chunk, a per-client run index over
+ * those copies and the delete log, so it can serve getDelta() and
+ * getDeleteDelta() like the live document. Chunks, run lists and log
+ * entries the writer has not touched since the previous version are
+ * shared with it instead of copied, so publishing after a small edit
+ * costs one pointer per chunk plus a copy of what changed. Nothing in a
+ * version changes after construction, so any number of threads may read
+ * it at once.
+ */
+template <typename T>
+class DocumentVersion {
+public:
+    using value_type = T;
+    using Atom = BasicAtom<T>;
+
+private:
+    using AtomChunk = BasicAtomChunk<T>;
+    static constexpr bool kIsText = std::is_same_v<T, char>;
+
+    struct Block {
+        const void* source;  // Live chunk this copies
+        uint64_t stamp;      // Its edit stamp when copied
+        size_t visible;
+        AtomChunk chunk;     // Links are cleared; block 0 holds the sentinel
+    };
+
+    // One run of a client, located in a block
+    struct RunEntry {
+        uint64_t start_clock;
+        const Block* block;
+        size_t run;     // Index into block->chunk.runs
+        size_t offset;  // Chunk offset of the run's first atom
+    };
+
+    // Run lists and delete logs are split into pages so a publish copies
+    // only the pages an edit touched and shares the rest
+    static constexpr size_t kPageSize = 64;
+    using RunPage = std::vector<RunEntry>;                            // Sorted by start_clock
+    using ClientRuns = std::vector<std::shared_ptr<const RunPage>>;   // Disjoint pages, in clock order
+    using LogPage = std::vector<DeleteOp>;
+
+    struct ClientLog {
+        uint64_t stamp = 0;  // Live log's edit stamp when captured
+        std::vector<std::shared_ptr<const LogPage>> pages;
+    };
+
+    uint64_t number_;
+    uint64_t clock_;
+    VectorClock vector_clock_;
+    std::vector<std::shared_ptr<const Block>> blocks_;
+    std::vector<size_t> visible_before_;       // Visible atoms before each block, plus the total
+    FlatHashMap<const void*, size_t> sources_; // Live chunk -> block, for the next version
+    FlatHashMap<uint64_t, ClientRuns> run_index_;    // client -> its runs
+    FlatHashMap<uint64_t, ClientLog> delete_logs_;   // client -> its delete log
+    size_t copied_ = 0;
+
+    /**
+     * @brief Call fn(client, entry) for every run in `block`.
+     */
+    template <typename Fn>
+    static void forEachRun(const Block* block, Fn&& fn) {
+        const AtomChunk& chunk = block->chunk;
+        size_t offset = 0;
+        for (size_t r = 0; r < chunk.run_count; r++) {
+            const AtomRun& run = chunk.runs[r];
+            fn(run.client_id, RunEntry{run.start_clock, block, r, offset});
+            offset += run.length;
+        }
+    }
+
+    /**
+     * @brief Page holding `clock`: the last one starting at or before it.
+     */
+    static size_t pageOf(const ClientRuns& pages, uint64_t clock) {
+        auto it = std::upper_bound(pages.begin(), pages.end(), clock,
+                                   [](uint64_t t, const auto& page) { return t < page->front().start_clock; });
+        return it == pages.begin() ? 0 : static_cast<size_t>(it - pages.begin()) - 1;
+    }
+
+    /**
+     * @brief Index the runs of every block. Starting from the previous
+     * version's pages, only pages holding runs of a copied or dropped
+     * block are rebuilt.
+     */
+    void buildRunIndex(const DocumentVersion* previous, const std::vector<bool>& kept,
+                       const std::vector<const Block*>& fresh) {
+        FlatHashMap<uint64_t, RunPage> added;
+        FlatHashMap<uint64_t, std::vector<uint64_t>> removed;  // client -> start clocks
+        FlatHashSet<const void*> dropped;
+        for (const Block* block : fresh) {
+            forEachRun(block, [&](uint64_t client, const RunEntry& entry) { added[client].push_back(entry); });
+        }
+        if (previous) {
+            run_index_ = previous->run_index_;
+            for (size_t b = 0; b < kept.size(); b++) {
+                if (kept[b]) continue;
+                const Block* block = previous->blocks_[b].get();
+                dropped.insert(block);
+                forEachRun(block, [&](uint64_t client, const RunEntry& entry) {
+                    removed[client].push_back(entry.start_clock);
+                });
+            }
+        }
+
+        auto byClock = [](const RunEntry& a, const RunEntry& b) { return a.start_clock < b.start_clock; };
+        auto rebuild = [&](uint64_t client) {
+            ClientRuns& pages = run_index_[client];
+            FlatHashMap<size_t, RunPage> edited;  // Page index -> its new contents
+            auto edit = [&](size_t p) -> RunPage& {
+                auto [it, inserted] = edited.tryEmplace(p);
+                if (inserted && p < pages.size()) {
+                    for (const RunEntry& entry : *pages[p]) {
+                        if (!dropped.count(entry.block)) it->second.push_back(entry);
+                    }
+                }
+                return it->second;
+            };
+            auto gone = removed.find(client);
+            if (gone != removed.end()) {
+                for (uint64_t clock : gone->second) edit(pageOf(pages, clock));
+            }
+            auto fresh_runs = added.find(client);
+            if (fresh_runs != added.end()) {
+                for (const RunEntry& entry : fresh_runs->second) {
+                    edit(pages.empty() ? 0 : pageOf(pages, entry.start_clock)).push_back(entry);
+                }
+            }
+
+            ClientRuns next;
+            next.reserve(pages.size() + 1);
+            for (size_t p = 0; p < std::max<size_t>(pages.size(), 1); p++) {
+                auto it = edited.find(p);
+                if (it == edited.end()) {
+                    if (p < pages.size()) next.push_back(pages[p]);
+                    continue;
+                }
+                RunPage& page = it->second;
+                std::sort(page.begin(), page.end(), byClock);
+                size_t parts = page.size() > 2 * kPageSize ? page.size() / kPageSize : 1;
+                for (size_t part = 0; part < parts && !page.empty(); part++) {
+                    auto from = page.begin() + part * page.size() / parts;
+                    auto to = page.begin() + (part + 1) * page.size() / parts;
+                    next.push_back(std::make_shared<const RunPage>(from, to));
+                }
+            }
+            if (next.empty()) run_index_.erase(client);
+            else pages = std::move(next);
+        };
+        for (const auto& entry : added) rebuild(entry.first);
+        for (const auto& entry : removed) {
+            if (!added.count(entry.first)) rebuild(entry.first);
+        }
+    }
+
+    /**
+     * @brief Capture the delete log. A client's log is shared with
+     * `previous` if unchanged, else its unchanged pages are.
+     */
+    template <typename Document>
+    void captureDeleteLog(const Document& doc, const DocumentVersion* previous) {
+        auto same = [](const DeleteOp& a, const DeleteOp& b) {
+            return a.client_id == b.client_id && a.start_clock == b.start_clock &&
+                   a.target.client_id == b.target.client_id && a.target.start_clock == b.target.start_clock &&
+                   a.target.step == b.target.step && a.target.length == b.target.length;
+        };
+        delete_logs_.reserve(doc.delete_log.size());
+        for (const auto& [client, log] : doc.delete_log) {
+            if (log.empty()) continue;
+            ClientLog captured;
+            auto stamp = doc.delete_log_stamps.find(client);
+            if (stamp != doc.delete_log_stamps.end()) captured.stamp = stamp->second;
+            const ClientLog* old = nullptr;
+            if (previous) {
+                auto it = previous->delete_logs_.find(client);
+                if (it != previous->delete_logs_.end()) old = &it->second;
+            }
+            if (old && captured.stamp != 0 && old->stamp == captured.stamp) {
+                captured.pages = old->pages;
+            } else {
+                for (size_t from = 0, p = 0; from < log.size(); from += kPageSize, p++) {
+                    auto first = log.begin() + from;
+                    auto last = first + std::min(kPageSize, log.size() - from);
+                    if (old && p < old->pages.size() && old->pages[p]->size() == static_cast<size_t>(last - first) &&
+                        std::equal(first, last, old->pages[p]->begin(), same)) {
+                        captured.pages.push_back(old->pages[p]);
+                    } else {
+                        captured.pages.push_back(std::make_shared<const LogPage>(first, last));
+                    }
+                }
+            }
+            delete_logs_[client] = std::move(captured);
+        }
+    }
+
+    bool visibleAt(size_t b, size_t offset) const {
+        return !blocks_[b]->chunk.deleted[offset] && (b > 0 || offset > 0);
+    }
+
+    /**
+     * @brief Call fn(value) for `count` visible elements from `index`.
+     */
+    template <typename Fn>
+    void forEachVisible(size_t index, size_t count, Fn&& fn) const {
+        if (index >= length() || count == 0) return;
+        size_t b = std::upper_bound(visible_before_.begin(), visible_before_.end(), index) -
+                   visible_before_.begin() - 1;
+        size_t skip = index - visible_before_[b];
+        for (; b < blocks_.size() && count > 0; b++) {
+            const AtomChunk& chunk = blocks_[b]->chunk;
+            for (size_t i = 0; i < chunk.size && count > 0; i++) {
+                if (!visibleAt(b, i)) continue;
+                if (skip > 0) {
+                    skip--;
+                    continue;
+                }
+                fn(chunk.content[i]);
+                count--;
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Copy `doc`, sharing unchanged chunks with `previous`.
+     * Call on the writer's thread; `previous` must come from the same document.
+     */
+    template <typename Document>
+    DocumentVersion(const Document& doc, const DocumentVersion* previous, uint64_t number)
+        : number_(number), clock_(doc.clock.peek()), vector_clock_(doc.vector_clock) {
+        static_assert(std::is_same_v<typename Document::value_type, T>, "Version element type must match");
+        blocks_.reserve(doc.chunk_count);
+        visible_before_.reserve(doc.chunk_count + 1);
+        sources_.reserve(doc.chunk_count);
+
+        std::vector<bool> kept(previous ? previous->blocks_.size() : 0, false);
+        std::vector<const Block*> fresh_blocks;
+        size_t total = 0;
+        for (const AtomChunk* chunk = doc.head; chunk; chunk = chunk->next) {
+            std::shared_ptr<const Block> block;
+            if (previous) {
+                auto it = previous->sources_.find(chunk);
+                if (it != previous->sources_.end() && previous->blocks_[it->second]->stamp == chunk->stamp) {
+                    block = previous->blocks_[it->second];
+                    kept[it->second] = true;
+                }
+            }
+            if (!block) {
+                auto fresh = std::make_shared<Block>();
+                fresh->source = chunk;
+                fresh->stamp = chunk->stamp;
+                fresh->visible = chunk->node->weight;
+                fresh->chunk = *chunk;
+                fresh->chunk.prev = fresh->chunk.next = nullptr;
+                fresh->chunk.node = nullptr;
+                fresh_blocks.push_back(fresh.get());
+                block = std::move(fresh);
+                copied_++;
+            }
+            sources_[chunk] = blocks_.size();
+            visible_before_.push_back(total);
+            total += block->visible;
+            blocks_.push_back(std::move(block));
+        }
+        visible_before_.push_back(total);
+
+        buildRunIndex(previous, kept, fresh_blocks);
+        captureDeleteLog(doc, previous);
+    }
+
+    DocumentVersion(const DocumentVersion&) = delete;
+    DocumentVersion& operator=(const DocumentVersion&) = delete;
+
+    /**
+     * @brief Publish counter: 0 for the first version, +1 per publish.
+     */
+    uint64_t number() const {
+        return number_;
+    }
+
+    uint64_t getClock() const {
+        return clock_;
+    }
+
+    const VectorClock& getVectorClock() const {
+        return vector_clock_;
+    }
+
+    /**
+     * @brief Number of visible elements.
+     */
+    size_t length() const {
+        return visible_before_.back();
+    }
+
+    /**
+     * @brief Chunks copied for this version (the rest are shared).
+     */
+    size_t copiedChunks() const {
+        return copied_;
+    }
+
+    size_t chunkCount() const {
+        return blocks_.size();
+    }
+
+    /**
+     * @brief Visible element at `index` (must be < length()).
+     */
+    T at(size_t index) const {
+        T value = T();
+        forEachVisible(index, 1, [&](const T& v) { value = v; });
+        return value;
+    }
+
+    /**
+     * @brief Up to `count` visible elements starting at `index`.
+     */
+    std::vector<T> items(size_t index, size_t count) const {
+        std::vector<T> result;
+        if (index < length()) result.reserve(std::min(count, length() - index));
+        forEachVisible(index, count, [&](const T& v) { result.push_back(v); });
+        return result;
+    }
+
+    std::string substring(size_t index, size_t len) const {
+        static_assert(kIsText, "substring() is for text; use items() for other element types");
+        std::string result;
+        if (index < length()) result.reserve(std::min(len, length() - index));
+        forEachVisible(index, len, [&](char c) { result += c; });
+        return result;
+    }
+
+    /**
+     * @brief Visible text, with '\0' stripped as in Sequence::toString().
+     */
+    std::string toString() const {
+        static_assert(kIsText, "toString() is for text; use items() for other element types");
+        std::string result;
+        result.reserve(length());
+        forEachVisible(0, length(), [&](char c) {
+            if (c != '\0') result += c;
+        });
+        return result;
+    }
+
+    /**
+     * @brief Atoms the peer has not seen, as Sequence::getDelta() returns them.
+     * Range-scans each client's runs from the peer's clock, so the cost
+     * follows the delta rather than the document.
+     */
+    std::vector<Atom> getDelta(const VectorClock& peer_state) const {
+        std::vector<Atom> delta;
+        for (const auto& [client_id, pages] : run_index_) {
+            uint64_t peer_time = peer_state.get(client_id);
+            size_t first = pageOf(pages, peer_time);
+            const RunPage& head = *pages[first];
+            size_t skip = std::upper_bound(head.begin(), head.end(), peer_time,
+                                           [](uint64_t t, const RunEntry& e) { return t < e.start_clock; }) -
+                          head.begin();
+            if (skip > 0) skip--;  // May straddle peer_time
+            for (size_t p = first; p < pages.size(); p++) {
+                const RunPage& page = *pages[p];
+                for (size_t e = p == first ? skip : 0; e < page.size(); e++) {
+                    const AtomChunk& chunk = page[e].block->chunk;
+                    const AtomRun& run = chunk.runs[page[e].run];
+                    size_t offset = page[e].offset;
+                    for (size_t j = 0; j < run.length; j++) {
+                        if (run.idAt(j).clock <= peer_time) continue;
+                        Atom atom(run.idAt(j), run.originAt(j), chunk.content[offset + j]);
+                        atom.is_deleted = chunk.deleted[offset + j];
+                        delta.push_back(atom);
+                    }
+                }
+            }
+        }
+
+        // Lamport order: every origin precedes the atoms inserted after it
+        std::sort(delta.begin(), delta.end(),
+                  [](const Atom& a, const Atom& b) { return a.id < b.id; });
+        return delta;
+    }
+
+    /**
+     * @brief Delete ops the peer has not seen, as Sequence::getDeleteDelta() returns them.
+     */
+    std::vector<DeleteOp> getDeleteDelta(const VectorClock& peer_state) const {
+        std::vector<DeleteOp> ops;
+        for (const auto& [client_id, log] : delete_logs_) {
+            uint64_t peer_time = peer_state.get(client_id);
+            for (const auto& page : log.pages) {
+                if (page->back().lastClock() > peer_time) appendUnseenDeleteOps(*page, peer_time, ops);
+            }
+        }
+        return ops;
+    }
+};
+
+/**
+ * @brief A document with one writer and lock-free snapshot readers (MVCC).
+ *
+ * The writer edits document() and calls publish() to make its changes
+ * visible. Readers call read() from any thread and get the latest
+ * published DocumentVersion; it stays valid, and unchanged, for as long
+ * as the guard lives, whatever the writer does meanwhile. Old versions
+ * are freed by epoch-based reclamation on the writer's next publish().
+ *
+ *   VersionedDocument<> doc(1);
+ *   doc.write([](Sequence& s) { s.localInsertString(0, "hi"); });  // writer
+ *   auto version = doc.read();                                     // any thread
+ *   std::string text = version->toString();
+ *
+ * Publish once per batch of edits rather than per keystroke: each
+ * publish walks the chunk list and copies the chunks that changed.
+ */
+template <typename Document = Sequence>
+class VersionedDocument {
+public:
+    using Version = DocumentVersion<typename Document::value_type>;
+
+    /**
+     * @brief A pinned version. Release it promptly so old versions can be freed.
+     */
+    class ReadGuard {
+        EpochManager::Guard guard_;
+        const Version* version_;
+
+    public:
+        ReadGuard(EpochManager::Guard guard, const Version* version)
+            : guard_(std::move(guard)), version_(version) {}
+
+        const Version& operator*() const { return *version_; }
+        const Version* operator->() const { return version_; }
+    };
+
+    explicit VersionedDocument(uint64_t client_id, size_t reader_slots = 64)
+        : doc_(client_id), epochs_(reader_slots) {
+        publish();
+    }
+
+    explicit VersionedDocument(Document&& doc, size_t reader_slots = 64)
+        : doc_(std::move(doc)), epochs_(reader_slots) {
+        publish();
+    }
+
+    ~VersionedDocument() {
+        delete current_.load(std::memory_order_relaxed);
+    }
+
+    VersionedDocument(const VersionedDocument&) = delete;
+    VersionedDocument& operator=(const VersionedDocument&) = delete;
+
+    /**
+     * @brief The live document. Writer thread only.
+     */
+    Document& document() {
+        return doc_;
+    }
+
+    /**
+     * @brief Make the document's current state visible to readers. Writer thread only.
+     */
+    const Version& publish() {
+        const Version* old = current_.load(std::memory_order_relaxed);
+        const Version* next = new Version(doc_, old, old ? old->number() + 1 : 0);
+        current_.store(next, std::memory_order_seq_cst);
+        if (old) epochs_.retire(old);
+        epochs_.reclaim();
+        return *next;
+    }
+
+    /**
+     * @brief Run fn(document()) and publish the result. Writer thread only.
+     */
+    template <typename Fn>
+    const Version& write(Fn&& fn) {
+        fn(doc_);
+        return publish();
+    }
+
+    /**
+     * @brief Latest published version. Any thread, no lock.
+     */
+    ReadGuard read() const {
+        EpochManager::Guard guard = epochs_.pin();
+        return ReadGuard(std::move(guard), current_.load(std::memory_order_seq_cst));
+    }
+
+    /**
+     * @brief Old versions still held by readers.
+     */
+    size_t pendingVersions() const {
+        return epochs_.pending();
+    }
+
+private:
+    Document doc_;
+    mutable EpochManager epochs_;
+    std::atomic<const Version*> current_{nullptr};
+};
+
+} // namespace core
+} // namespace omnisync
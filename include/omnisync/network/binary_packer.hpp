@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <cstring>
 #include "../core/crdt_atom.hpp"
+#include "../core/content_codec.hpp"
 #include "vle_encoding.hpp"
 
 namespace omnisync {
@@ -101,15 +102,17 @@ public:
  * [VLE] Clock
  * [VLE] Origin Client ID
  * [VLE] Origin Clock
- * [1]   Content (char)
+ * [1]   Content (char; other element types per ContentCodec)
  * [1]   IsDeleted (bool/byte)
  */
 class VLEPacker {
 public:
     /**
      * @brief Serialize an Atom using Variable-Length Encoding.
+     * Content of other element types is written by ContentCodec.
      */
-    static std::vector<uint8_t> pack(const Atom& atom) {
+    template <typename T>
+    static std::vector<uint8_t> pack(const BasicAtom<T>& atom) {
         std::vector<uint8_t> buffer;
         buffer.reserve(10); // Estimated average size
 
@@ -119,8 +122,7 @@ public:
         VLEEncoding::encodeUInt64(atom.origin.client_id, buffer);
         VLEEncoding::encodeUInt64(atom.origin.clock, buffer);
 
-        // Fixed-size fields
-        buffer.push_back((uint8_t)atom.content);
+        ContentCodec<T>::encode(atom.content, buffer);
         buffer.push_back(atom.is_deleted ? 1 : 0);
 
         return buffer;
@@ -129,7 +131,8 @@ public:
     /**
      * @brief Deserialize VLE-encoded bytes back into an Atom.
      */
-    static bool unpack(const std::vector<uint8_t>& buffer, Atom& out_atom) {
+    template <typename T>
+    static bool unpack(const std::vector<uint8_t>& buffer, BasicAtom<T>& out_atom) {
         size_t offset = 0;
 
         // Decode 4 integers
@@ -142,10 +145,10 @@ public:
         if (!VLEEncoding::decodeUInt64(buffer, offset, out_atom.origin.clock)) 
             return false;
 
-        // Check if we have 2 more bytes for content and flag
-        if (offset + 2 > buffer.size()) return false;
+        // Content, then one byte for the flag
+        if (!ContentCodec<T>::decode(buffer, offset, out_atom.content)) return false;
+        if (offset >= buffer.size()) return false;
 
-        out_atom.content = (char)buffer[offset++];
         out_atom.is_deleted = (buffer[offset++] != 0);
 
         return true;
@@ -154,12 +157,163 @@ public:
     /**
      * @brief Calculate the exact size needed to encode this atom.
      */
-    static size_t packedSize(const Atom& atom) {
+    template <typename T>
+    static size_t packedSize(const BasicAtom<T>& atom) {
         return VLEEncoding::encodedSize(atom.id.client_id) +
                VLEEncoding::encodedSize(atom.id.clock) +
                VLEEncoding::encodedSize(atom.origin.client_id) +
                VLEEncoding::encodedSize(atom.origin.clock) +
-               2; // content + is_deleted
+               ContentCodec<T>::encodedSize(atom.content) +
+               1; // is_deleted
+    }
+
+    /**
+     * @brief Serialize a batch of atoms (see Sequence::getDelta).
+     * Layout: [VLE] Atom count, then each atom as in pack()
+     */
+    template <typename T>
+    static std::vector<uint8_t> packAtoms(const std::vector<BasicAtom<T>>& atoms) {
+        std::vector<uint8_t> buffer;
+        buffer.reserve(1 + atoms.size() * 8);
+
+        VLEEncoding::encodeUInt64(atoms.size(), buffer);
+        for (const auto& atom : atoms) {
+            VLEEncoding::encodeUInt64(atom.id.client_id, buffer);
+            VLEEncoding::encodeUInt64(atom.id.clock, buffer);
+            VLEEncoding::encodeUInt64(atom.origin.client_id, buffer);
+            VLEEncoding::encodeUInt64(atom.origin.clock, buffer);
+            ContentCodec<T>::encode(atom.content, buffer);
+            buffer.push_back(atom.is_deleted ? 1 : 0);
+        }
+
+        return buffer;
+    }
+
+    /**
+     * @brief Deserialize a batch of atoms. Rejects truncated input.
+     */
+    template <typename T>
+    static bool unpackAtoms(const std::vector<uint8_t>& buffer, std::vector<BasicAtom<T>>& out_atoms) {
+        size_t offset = 0;
+        uint64_t count;
+        if (!VLEEncoding::decodeUInt64(buffer, offset, count)) return false;
+
+        // Every atom takes at least 6 bytes
+        if (count > (buffer.size() - offset) / 6) return false;
+
+        out_atoms.clear();
+        out_atoms.reserve(count);
+        for (uint64_t i = 0; i < count; i++) {
+            BasicAtom<T> atom;
+            if (!VLEEncoding::decodeUInt64(buffer, offset, atom.id.client_id)) return false;
+            if (!VLEEncoding::decodeUInt64(buffer, offset, atom.id.clock)) return false;
+            if (!VLEEncoding::decodeUInt64(buffer, offset, atom.origin.client_id)) return false;
+            if (!VLEEncoding::decodeUInt64(buffer, offset, atom.origin.clock)) return false;
+            if (!ContentCodec<T>::decode(buffer, offset, atom.content)) return false;
+            if (offset >= buffer.size()) return false;
+            atom.is_deleted = (buffer[offset++] != 0);
+            out_atoms.push_back(atom);
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Serialize range deletes (see Sequence::localDeleteRange).
+     * Layout: [VLE] Span count, then per span
+     * [VLE] Client ID, [VLE] Start clock, [VLE] Step, [VLE] Length
+     */
+    static std::vector<uint8_t> packDeleteSpans(const std::vector<DeleteSpan>& spans) {
+        std::vector<uint8_t> buffer;
+        buffer.reserve(1 + spans.size() * 6);
+
+        VLEEncoding::encodeUInt64(spans.size(), buffer);
+        for (const auto& span : spans) {
+            VLEEncoding::encodeUInt64(span.client_id, buffer);
+            VLEEncoding::encodeUInt64(span.start_clock, buffer);
+            VLEEncoding::encodeUInt64(span.step, buffer);
+            VLEEncoding::encodeUInt64(span.length, buffer);
+        }
+
+        return buffer;
+    }
+
+    /**
+     * @brief Deserialize range deletes. Rejects truncated or empty spans
+     * and spans whose clocks run past 64 bits.
+     */
+    static bool unpackDeleteSpans(const std::vector<uint8_t>& buffer, std::vector<DeleteSpan>& out_spans) {
+        size_t offset = 0;
+        uint64_t count;
+        if (!VLEEncoding::decodeUInt64(buffer, offset, count)) return false;
+
+        // Every span takes at least 4 bytes
+        if (count > (buffer.size() - offset) / 4) return false;
+
+        out_spans.clear();
+        out_spans.reserve(count);
+        for (uint64_t i = 0; i < count; i++) {
+            DeleteSpan span;
+            if (!VLEEncoding::decodeUInt64(buffer, offset, span.client_id)) return false;
+            if (!VLEEncoding::decodeUInt64(buffer, offset, span.start_clock)) return false;
+            if (!VLEEncoding::decodeUInt64(buffer, offset, span.step)) return false;
+            if (!VLEEncoding::decodeUInt64(buffer, offset, span.length)) return false;
+            if (!span.valid()) return false;
+            out_spans.push_back(span);
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Serialize delete operations (see Sequence::getDeleteDelta).
+     * Layout: [VLE] Op count, then per op
+     * [VLE] Client ID, [VLE] Start clock, then the target span as in packDeleteSpans
+     */
+    static std::vector<uint8_t> packDeleteOps(const std::vector<DeleteOp>& ops) {
+        std::vector<uint8_t> buffer;
+        buffer.reserve(1 + ops.size() * 9);
+
+        VLEEncoding::encodeUInt64(ops.size(), buffer);
+        for (const auto& op : ops) {
+            VLEEncoding::encodeUInt64(op.client_id, buffer);
+            VLEEncoding::encodeUInt64(op.start_clock, buffer);
+            VLEEncoding::encodeUInt64(op.target.client_id, buffer);
+            VLEEncoding::encodeUInt64(op.target.start_clock, buffer);
+            VLEEncoding::encodeUInt64(op.target.step, buffer);
+            VLEEncoding::encodeUInt64(op.target.length, buffer);
+        }
+
+        return buffer;
+    }
+
+    /**
+     * @brief Deserialize delete operations. Rejects truncated or empty ops,
+     * clocks that overflow, and targets newer than the op deleting them.
+     */
+    static bool unpackDeleteOps(const std::vector<uint8_t>& buffer, std::vector<DeleteOp>& out_ops) {
+        size_t offset = 0;
+        uint64_t count;
+        if (!VLEEncoding::decodeUInt64(buffer, offset, count)) return false;
+
+        // Every op takes at least 6 bytes
+        if (count > (buffer.size() - offset) / 6) return false;
+
+        out_ops.clear();
+        out_ops.reserve(count);
+        for (uint64_t i = 0; i < count; i++) {
+            DeleteOp op;
+            if (!VLEEncoding::decodeUInt64(buffer, offset, op.client_id)) return false;
+            if (!VLEEncoding::decodeUInt64(buffer, offset, op.start_clock)) return false;
+            if (!VLEEncoding::decodeUInt64(buffer, offset, op.target.client_id)) return false;
+            if (!VLEEncoding::decodeUInt64(buffer, offset, op.target.start_clock)) return false;
+            if (!VLEEncoding::decodeUInt64(buffer, offset, op.target.step)) return false;
+            if (!VLEEncoding::decodeUInt64(buffer, offset, op.target.length)) return false;
+            if (!op.valid()) return false;
+            out_ops.push_back(op);
+        }
+
+        return true;
     }
 };
 
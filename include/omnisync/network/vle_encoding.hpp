@@ -125,11 +125,11 @@ public:
      * - 2 → 4
      * 
      * This makes small negative numbers encode efficiently.
-     * (Not needed for CRDTs, but included for completeness)
+     * (Used for clock deltas in columnar snapshots)
      */
     static void encodeInt64(int64_t value, std::vector<uint8_t>& out) {
         // ZigZag encoding: (n << 1) ^ (n >> 63)
-        uint64_t zigzag = (uint64_t)((value << 1) ^ (value >> 63));
+        uint64_t zigzag = ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
         encodeUInt64(zigzag, out);
     }
 
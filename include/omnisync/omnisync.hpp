@@ -23,8 +23,18 @@
 // Core Components
 #include "core/crdt_atom.hpp"
 #include "core/lamport_clock.hpp"
+#include "core/sequence_policy.hpp"
 #include "core/vector_clock.hpp"
+#include "core/flat_hash_map.hpp"
 #include "core/sequence.hpp"
+#include "core/snapshot_view.hpp"
+#include "core/mapped_document.hpp"
+#include "core/op_log.hpp"
+#include "core/epoch.hpp"
+#include "core/versioned_document.hpp"
+#include "core/mpsc_queue.hpp"
+#include "core/ingest_queue.hpp"
+#include "core/document_store.hpp"
 #include "core/gc_coordinator.hpp"
 
 // Network Helpers
@@ -0,0 +1,203 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <limits>
+#include <sstream>
+#include <string>
+#include "omnisync/omnisync.hpp"
+
+using namespace omnisync::core;
+
+static std::string makeText(size_t length, char base) {
+    std::string text;
+    for (size_t i = 0; i < length; i++) text += static_cast<char>(base + (i % 26));
+    return text;
+}
+
+/**
+ * Test 1: A pasted string matches typing it character by character
+ */
+void test_insert_string_matches_typing() {
+    std::cout << "Test 1: localInsertString matches typing..." << std::endl;
+
+    Sequence pasted(1), typed(1);
+    for (int i = 0; i < 300; i++) {
+        pasted.localInsert(i, 'x');
+        typed.localInsert(i, 'x');
+    }
+
+    std::string text = makeText(1000, 'a');
+    std::vector<Atom> ops = pasted.localInsertString(300, text);
+    for (size_t i = 0; i < text.size(); i++) {
+        Atom op = typed.localInsert(300 + i, text[i]);
+        assert(op.id == ops[i].id);
+        assert(op.origin == ops[i].origin);
+    }
+    assert(ops.size() == text.size());
+    assert(pasted.toString() == typed.toString());
+    assert(pasted.getVectorClock().get(1) == typed.getVectorClock().get(1));
+
+    // Later edits see the same clock
+    assert(pasted.localInsert(0, '!').id == typed.localInsert(0, '!').id);
+    assert(pasted.localInsertString(5, "").empty());
+
+    std::cout << "  PASS" << std::endl;
+}
+
+/**
+ * Test 2: Broadcast batches converge on remote replicas
+ */
+void test_insert_string_broadcast() {
+    std::cout << "Test 2: Pasted batches converge remotely..." << std::endl;
+
+    Sequence alice(1), bob(2);
+    for (const Atom& op : alice.localInsertString(0, makeText(500, 'a'))) bob.remoteMerge(op);
+
+    // Concurrent pastes into the middle of the same run
+    std::vector<Atom> from_alice = alice.localInsertString(200, makeText(700, 'A'));
+    std::vector<Atom> from_bob = bob.localInsertString(250, "concurrent");
+    for (const Atom& op : from_alice) bob.remoteMerge(op);
+    for (const Atom& op : from_bob) alice.remoteMerge(op);
+    assert(alice.toString() == bob.toString());
+    assert(alice.toString().size() == 1210);
+
+    // Out-of-order delivery goes through the orphan buffer
+    Sequence carol(3);
+    std::vector<Atom> all = alice.getDelta(VectorClock());
+    carol.setOrphanConfig({10000, std::numeric_limits<uint64_t>::max()});  // Every atom waits out the whole batch
+    for (auto it = all.rbegin(); it != all.rend(); ++it) carol.remoteMerge(*it);
+    assert(carol.toString() == alice.toString());
+    assert(carol.getOrphanBufferSize() == 0);
+
+    std::stringstream buffer;
+    alice.save(buffer);
+    Sequence restored(4);
+    assert(restored.load(buffer));
+    assert(restored.toString() == alice.toString());
+
+    std::cout << "  PASS" << std::endl;
+}
+
+/**
+ * Test 3: Large pastes stay fast and compact
+ */
+void test_large_paste() {
+    std::cout << "Test 3: 100 KB paste..." << std::endl;
+
+    Sequence doc(1);
+    doc.localInsertString(0, makeText(1000, 'a'));
+
+    std::string text = makeText(100000, 'A');
+    auto start = std::chrono::high_resolution_clock::now();
+    doc.localInsertString(500, text);
+    auto end = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+    std::string result = doc.toString();
+    assert(result.size() == 101000);
+    assert(result.find(text) != std::string::npos);
+
+    MemoryStats stats = doc.getMemoryStats();
+    std::cout << "  Pasted 100000 chars in " << ms << " ms (" << stats.run_count << " runs)" << std::endl;
+    assert(stats.run_count < 1000);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+/**
+ * Test 4: Range deletes match single deletes and travel as a few spans
+ */
+void test_delete_range() {
+    std::cout << "Test 4: localDeleteRange..." << std::endl;
+
+    Sequence alice(1), bob(2);
+    std::string model = makeText(60000, 'a');
+    for (const Atom& op : alice.localInsertString(0, model)) bob.remoteMerge(op);
+
+    // A few scattered deletes leave tombstones inside the range
+    for (int i = 0; i < 10; i++) {
+        bob.remoteDelete(alice.localDelete(5000 + i * 100));
+        model.erase(5000 + i * 100, 1);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<DeleteSpan> spans = alice.localDeleteRange(1000, 50000);
+    auto end = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    model.erase(1000, 50000);
+
+    uint64_t covered = 0;
+    for (const auto& span : spans) covered += span.length;
+    std::cout << "  Deleted 50000 chars in " << ms << " ms as " << spans.size() << " spans" << std::endl;
+    assert(covered == 50000);
+    assert(spans.size() <= 11);
+    assert(alice.toString() == model);
+    assert(alice.getTombstoneCount() == 50010);
+
+    // Wire round trip, then apply on the peer
+    std::vector<uint8_t> wire = omnisync::network::VLEPacker::packDeleteSpans(spans);
+    std::vector<DeleteSpan> received;
+    assert(omnisync::network::VLEPacker::unpackDeleteSpans(wire, received));
+    assert(wire.size() < 100);
+    bob.remoteDeleteRange(received);
+    assert(bob.toString() == model);
+    assert(bob.getTombstoneCount() == alice.getTombstoneCount());
+
+    // Clipped at the end, no-op past it
+    assert(alice.localDeleteRange(model.size(), 5).empty());
+    spans = alice.localDeleteRange(model.size() - 3, 100);
+    assert(spans.size() == 1 && spans[0].length == 3);
+    model.erase(model.size() - 3);
+    assert(alice.toString() == model);
+
+    // Positions still resolve after the batched weight refresh
+    alice.localDelete(0);
+    alice.localDelete(model.size() - 2);
+    model.erase(model.size() - 1);
+    model.erase(0, 1);
+    assert(alice.toString() == model);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+/**
+ * Test 5: Forged span lengths stop at what the receiver can hold
+ */
+void test_delete_range_bounded() {
+    std::cout << "Test 5: Range delete with a forged length..." << std::endl;
+
+    Sequence alice(1), bob(2);
+    std::vector<Atom> ops = alice.localInsertString(0, makeText(300, 'a'));
+    for (size_t i = 0; i < 200; i++) bob.remoteMerge(ops[i]);
+    bob.setOrphanConfig({50, 1000});
+
+    // Covers the 200 atoms bob has, then 2^60 more ids in the same pattern
+    uint64_t step = ops[1].id.clock - ops[0].id.clock;
+    auto start = std::chrono::high_resolution_clock::now();
+    bob.remoteDeleteRange({{1, ops[0].id.clock, step, uint64_t(1) << 60}});
+    auto end = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    std::cout << "  Applied in " << ms << " ms" << std::endl;
+    assert(bob.length() == 0);
+    assert(bob.getMemoryStats().delete_buffer_count == 50);
+
+    // Buffered ids still delete their atoms once those arrive
+    for (size_t i = 200; i < 300; i++) bob.remoteMerge(ops[i]);
+    assert(bob.length() == 50);
+    assert(bob.getMemoryStats().delete_buffer_count == 0);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== OmniSync Bulk Edit Tests ===" << std::endl << std::endl;
+
+    test_insert_string_matches_typing();
+    test_insert_string_broadcast();
+    test_large_paste();
+    test_delete_range();
+    test_delete_range_bounded();
+
+    std::cout << std::endl << "=== ALL TESTS PASSED ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,237 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <ctime>
+#include <future>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "omnisync/omnisync.hpp"
+
+using namespace omnisync::core;
+
+static std::string toText(const Sequence& doc) {
+    return doc.toString();
+}
+
+static void test_routing_and_ownership() {
+    DocumentStore<>::Config config;
+    config.workers = 4;
+    DocumentStore<> store(1, config);
+    assert(store.shardCount() == 4);
+
+    // Every call on an id runs on the same worker; ids spread over all of them
+    std::set<std::thread::id> workers;
+    std::vector<size_t> per_shard(4, 0);
+    for (int i = 0; i < 200; i++) {
+        std::string id = "doc-" + std::to_string(i);
+        size_t shard = store.shardOf(id);
+        assert(shard == store.shardOf(id) && shard < 4);
+        per_shard[shard]++;
+        auto first = store.update(id, [](Sequence&) { return std::this_thread::get_id(); });
+        auto second = store.read(id, [](const Sequence&) { return std::this_thread::get_id(); });
+        std::thread::id owner = first.get();
+        assert(owner == second.get() && owner != std::this_thread::get_id());
+        workers.insert(owner);
+    }
+    assert(workers.size() == 4);
+    for (size_t count : per_shard) assert(count > 20);
+    assert(store.documentCount() == 200);
+}
+
+static void test_async_calls() {
+    DocumentStore<> store(1);
+
+    // Calls on one document run in order, so no waiting in between
+    Sequence alice(2);
+    std::vector<Atom> hello = alice.localInsertString(0, "hello world");
+    store.applyDelta("greeting", hello);
+    alice.localDeleteRange(0, 6);
+    std::vector<DeleteOp> deletes = alice.getDeleteDelta(VectorClock());
+    store.applyDeleteOps("greeting", deletes);
+    std::future<DeltaStats> dup = store.applyDelta("greeting", hello);
+    std::future<std::string> text = store.read("greeting", toText);
+    assert(text.get() == "world");
+    assert(dup.get().duplicates == hello.size());
+
+    // Reads never create documents
+    assert(store.read("missing", toText).get().empty());
+    assert(store.documentCount() == 1);
+
+    // Deltas and clocks for a peer catching up
+    Sequence bob(3);
+    bob.applyDelta(store.getDelta("greeting", bob.getVectorClock()).get());
+    assert(bob.toString() == "world");
+    assert(store.getVectorClock("greeting").get().get(2) >= hello.back().id.clock);
+
+    // Snapshot to bytes and back, under another id
+    std::string bytes = store.snapshot("greeting").get();
+    assert(store.restore("copy", bytes).get());
+    assert(store.read("copy", toText).get() == "world");
+    assert(!store.restore("broken", "not a document").get());
+
+    // Local edits through update(), results through the future
+    size_t length = store.update("copy", [](Sequence& doc) {
+        doc.localInsertString(doc.length(), "!");
+        return doc.length();
+    }).get();
+    assert(length == 6);
+
+    // Exceptions come back through the future
+    std::future<void> failing = store.update("copy", [](Sequence&) { throw std::runtime_error("boom"); });
+    bool threw = false;
+    try {
+        failing.get();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    assert(store.erase("copy").get());
+    assert(!store.erase("copy").get());
+    assert(store.documentCount() == 2);  // "greeting" and the failed "broken"
+}
+
+static void test_many_documents() {
+    const int kDocs = 20000;
+    DocumentStore<Sequence, uint64_t> store(1);
+
+    // Network threads route ops for many documents at once
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> senders;
+    for (int t = 0; t < 4; t++) {
+        senders.emplace_back([&store, t] {
+            std::vector<std::future<DeltaStats>> pending;
+            for (uint64_t doc = t; doc < kDocs; doc += 4) {
+                Atom op({10 + uint64_t(t), doc + 1}, {0, 0}, 'x');
+                pending.push_back(store.applyDelta(doc, {op}));
+            }
+            for (auto& f : pending) assert(f.get().applied == 1);
+        });
+    }
+    for (auto& t : senders) t.join();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    assert(store.documentCount() == kDocs);
+    std::vector<std::future<size_t>> lengths;
+    for (uint64_t doc = 0; doc < kDocs; doc += 997) {
+        lengths.push_back(store.read(doc, [](const Sequence& d) { return d.length(); }));
+    }
+    for (auto& f : lengths) assert(f.get() == 1);
+    std::cout << "  " << kDocs << " documents on " << store.shardCount() << " workers in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+}
+
+static void test_full_queue_and_idle_workers() {
+    DocumentStore<>::Config config;
+    config.workers = 2;
+    config.queue_capacity = 4;
+    DocumentStore<> store(1, config);
+
+    // A slow document fills its shard's queue; callers sleep until the worker makes room
+    std::promise<void> gate;
+    std::shared_future<void> open = gate.get_future().share();
+    auto held = store.update("slow", [open](Sequence& doc) {
+        open.wait();
+        doc.localInsertString(0, "done");
+        return true;
+    });
+    std::thread caller([&store] {
+        std::vector<std::future<size_t>> pending;
+        for (int i = 0; i < 64; i++) {
+            pending.push_back(store.update("slow", [](Sequence& doc) {
+                doc.localInsert(doc.length(), '.');
+                return doc.length();
+            }));
+        }
+        for (auto& f : pending) f.get();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::clock_t cpu_start = std::clock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    double blocked_ms = 1000.0 * (std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    gate.set_value();
+    caller.join();
+    assert(held.get());
+    assert(store.read("slow", toText).get() == "done" + std::string(64, '.'));
+
+    // Idle workers sleep instead of polling
+    DocumentStore<>::Config wide;
+    wide.workers = 64;
+    DocumentStore<> idle(2, wide);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    cpu_start = std::clock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    double idle_ms = 1000.0 * (std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    std::cout << "  blocked caller used " << blocked_ms << " ms CPU in 100 ms; 64 idle workers used "
+              << idle_ms << " ms CPU in 200 ms\n";
+    assert(blocked_ms < 20 && idle_ms < 20);
+}
+
+static void test_close_with_blocked_caller() {
+    DocumentStore<>::Config config;
+    config.workers = 1;
+    config.queue_capacity = 2;
+    DocumentStore<> store(1, config);
+
+    // The worker is held in one call and the caller fills the queue, so
+    // its third call waits for room, unless close() got there first
+    std::promise<void> gate, queued;
+    std::shared_future<void> open = gate.get_future().share();
+    auto held = store.update("doc", [open](Sequence&) {
+        open.wait();
+        return 0;
+    });
+    std::vector<std::future<size_t>> pending;
+    std::thread caller([&] {
+        for (int i = 0; i < 3; i++) {
+            if (i == 2) queued.set_value();
+            pending.push_back(store.update("doc", [](Sequence& doc) {
+                doc.localInsert(doc.length(), '.');
+                return doc.length();
+            }));
+        }
+    });
+    queued.get_future().wait();
+    std::thread closer([&store] { store.close(); });  // Must wake the caller, not hang
+    gate.set_value();
+    closer.join();
+    caller.join();
+
+    // Calls that got in ran in order; any after close() started failed
+    assert(held.get() == 0);
+    assert(pending.size() == 3);
+    size_t ran = 0;
+    for (auto& f : pending) {
+        try {
+            assert(f.get() == ++ran);
+        } catch (const std::future_error& e) {
+            assert(e.code() == std::future_errc::broken_promise);
+        }
+    }
+    assert(ran >= 2);
+}
+
+int main() {
+    std::cout << "--- OmniSync Document Store Test ---\n";
+
+    test_routing_and_ownership();
+    std::cout << "Routing and ownership: PASS\n";
+
+    test_async_calls();
+    std::cout << "Async calls: PASS\n";
+
+    test_many_documents();
+    std::cout << "Many documents: PASS\n";
+
+    test_full_queue_and_idle_workers();
+    std::cout << "Full queues and idle workers: PASS\n";
+
+    test_close_with_blocked_caller();
+    std::cout << "Close with a blocked caller: PASS\n";
+
+    std::cout << "SUCCESS: Document Store Verified.\n";
+    return 0;
+}
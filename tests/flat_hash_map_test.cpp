@@ -0,0 +1,112 @@
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "omnisync/omnisync.hpp"
+
+using namespace omnisync::core;
+
+/**
+ * Test 1: Random inserts/erases agree with std::unordered_map
+ */
+void test_matches_std_map() {
+    std::cout << "Test 1: Random operations vs std::unordered_map..." << std::endl;
+
+    FlatHashMap<OpID, std::vector<Atom>> flat;
+    std::unordered_map<OpID, std::vector<Atom>> reference;
+    std::mt19937 rng(11);
+
+    for (int i = 0; i < 200000; i++) {
+        OpID key = {rng() % 8, rng() % 4000};
+        int op = rng() % 10;
+        if (op < 5) {
+            Atom atom(key, {0, 0}, 'x');
+            flat[key].push_back(atom);
+            reference[key].push_back(atom);
+        } else if (op < 8) {
+            assert(flat.erase(key) == reference.erase(key));
+        } else {
+            auto it = flat.find(key);
+            auto ref_it = reference.find(key);
+            assert((it == flat.end()) == (ref_it == reference.end()));
+            if (it != flat.end()) assert(it->second.size() == ref_it->second.size());
+        }
+    }
+    assert(flat.size() == reference.size());
+
+    size_t visited = 0;
+    for (const auto& [key, values] : flat) {
+        assert(reference.count(key));
+        assert(reference[key].size() == values.size());
+        visited++;
+    }
+    assert(visited == reference.size());
+
+    std::cout << "  PASS" << std::endl;
+}
+
+/**
+ * Test 2: Sets, copies, moves and clears keep entries consistent
+ */
+void test_set_copy_move() {
+    std::cout << "Test 2: Set, copy and move..." << std::endl;
+
+    FlatHashSet<OpID> set;
+    for (uint64_t c = 1; c <= 5000; c++) assert(set.insert({7, c}));
+    assert(!set.insert({7, 42}));
+    for (uint64_t c = 1; c <= 5000; c += 2) assert(set.erase({7, c}) == 1);
+    assert(set.size() == 2500);
+    for (uint64_t c = 1; c <= 5000; c++) assert(set.count({7, c}) == (c % 2 == 0 ? 1u : 0u));
+
+    FlatHashMap<uint64_t, std::string> names;
+    names[1] = "alice";
+    names[2] = "bob";
+    FlatHashMap<uint64_t, std::string> copy(names);
+    FlatHashMap<uint64_t, std::string> moved(std::move(names));
+    assert(copy.size() == 2 && moved.size() == 2);
+    assert(copy[1] == "alice" && moved.find(2)->second == "bob");
+
+    moved.clear();
+    assert(moved.empty() && moved.find(1) == moved.end());
+    assert(copy.count(2) == 1);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+/**
+ * Test 3: Sequential clocks spread evenly across buckets
+ */
+void test_hash_quality() {
+    std::cout << "Test 3: OpID hash spreads sequential clocks..." << std::endl;
+
+    const size_t buckets = 1 << 12;
+    std::vector<size_t> load(buckets, 0);
+    std::hash<OpID> hasher;
+    for (uint64_t client = 1; client <= 4; client++) {
+        for (uint64_t clock = 1; clock <= 4096; clock++) {
+            load[hasher({client, clock}) & (buckets - 1)]++;
+        }
+    }
+
+    // 16384 keys over 4096 buckets: expect ~4 per bucket
+    size_t worst = 0;
+    for (size_t l : load) worst = std::max(worst, l);
+    std::cout << "  Worst bucket: " << worst << " keys" << std::endl;
+    assert(worst < 20);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== OmniSync Flat Hash Map Tests ===" << std::endl << std::endl;
+
+    test_matches_std_map();
+    test_set_copy_move();
+    test_hash_quality();
+
+    std::cout << std::endl << "=== ALL TESTS PASSED ===" << std::endl;
+    return 0;
+}
@@ -1,5 +1,8 @@
 #include <iostream>
 #include <cassert>
+#include <chrono>
+#include <sstream>
+#include <string>
 #include <vector>
 #include "omnisync/omnisync.hpp"
 
@@ -214,6 +217,104 @@ void test_memory_stats() {
     std::cout << "  PASS" << std::endl;
 }
 
+/**
+ * Test 6: GC cost follows the tombstones, not the document size
+ */
+void test_gc_tombstone_index() {
+    std::cout << "Test 6: Indexed GC on a large document..." << std::endl;
+
+    Sequence alice(1), bob(2);
+    std::vector<Atom> bulk = alice.localInsertString(0, std::string(1000000, 'x'));
+    bob.applyDelta(bulk);
+
+    // Tombstones from every delete path
+    for (int i = 0; i < 200; i++) bob.remoteDelete(alice.localDelete(i * 4000));
+    bob.remoteDeleteRange(alice.localDeleteRange(500000, 250));
+    assert(alice.getTombstoneCount() == 450);
+
+    // Only tombstones below bob's frontier for alice go
+    VectorClock frontier;
+    frontier.update(1, bulk[600000].id.clock);
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t removed = alice.garbageCollect(frontier);
+    auto end = std::chrono::high_resolution_clock::now();
+    double us = std::chrono::duration<double, std::micro>(end - start).count();
+    std::cout << "  Removed " << removed << " tombstones from 1M atoms in " << us << " us" << std::endl;
+    assert(removed == 150 + 250);
+    assert(alice.getTombstoneCount() == 50);
+
+    // Nothing left to collect: no scan either
+    start = std::chrono::high_resolution_clock::now();
+    assert(alice.garbageCollect(frontier) == 0);
+    end = std::chrono::high_resolution_clock::now();
+    us = std::chrono::duration<double, std::micro>(end - start).count();
+    std::cout << "  Empty GC pass in " << us << " us" << std::endl;
+
+    // A reloaded replica still finds its tombstones
+    std::stringstream buffer;
+    bob.save(buffer);
+    Sequence restored(3);
+    assert(restored.load(buffer));
+    assert(restored.garbageCollectLocal(0) == 450);
+    assert(bob.garbageCollectLocal(0) == 450);
+    assert(restored.toString() == bob.toString());
+    assert(alice.garbageCollectLocal(0) == 50);
+    assert(alice.toString() == bob.toString());
+
+    std::cout << "  PASS" << std::endl;
+}
+
+/**
+ * Test 7: Incremental GC steps and a bounded auto-GC pause
+ */
+void test_incremental_gc() {
+    std::cout << "Test 7: Incremental GC..." << std::endl;
+
+    Sequence alice(1), bob(2);
+    bob.applyDelta(alice.localInsertString(0, std::string(20000, 'x')));
+    bob.remoteDeleteRange(alice.localDeleteRange(1000, 10000));
+    std::string text = alice.toString();
+
+    // Fixed-size steps resume until the frontier is drained
+    VectorClock frontier = bob.getVectorClock();
+    size_t steps = 0, total = 0;
+    while (size_t removed = alice.garbageCollectStep(frontier, 1000)) {
+        assert(removed <= 1000);
+        assert(alice.toString() == text);
+        total += removed;
+        steps++;
+    }
+    assert(steps == 10 && total == 10000);
+    assert(alice.getTombstoneCount() == 0);
+
+    // A tiny time budget stops early but still makes progress
+    size_t removed = bob.garbageCollectLocalStep(0, 0, 1);
+    std::cout << "  1 us budget removed " << removed << " of 10000" << std::endl;
+    assert(removed > 0 && removed < 10000);
+    while (bob.garbageCollectLocalStep(0, 0, 1)) {}
+    assert(bob.getTombstoneCount() == 0);
+    assert(bob.toString() == text);
+
+    // Auto-GC removes at most one batch per edit
+    Sequence doc(3);
+    Sequence::GCConfig config;
+    config.auto_gc_enabled = true;
+    config.tombstone_threshold = 100;
+    config.min_age_threshold = 0;
+    config.max_items_per_step = 50;
+    doc.setGCConfig(config);
+    doc.localInsertString(0, std::string(5000, 'y'));
+    doc.localDeleteRange(0, 4000);
+    assert(doc.getTombstoneCount() == 3950);
+    doc.localDelete(0);
+    assert(doc.getTombstoneCount() == 3901);
+    while (doc.getTombstoneCount() >= config.tombstone_threshold) doc.localDelete(0);
+    assert(doc.getMemoryStats().gc_stats.total_tombstones_removed > 3900);
+    assert(doc.toString().size() + doc.getTombstoneCount() + doc.getMemoryStats().gc_stats.total_tombstones_removed == 5000);
+
+    std::cout << "  PASS" << std::endl;
+}
+
 int main() {
     std::cout << "=== OmniSync v1.3 Garbage Collection Tests ===" << std::endl << std::endl;
     
@@ -223,6 +324,8 @@ int main() {
         test_gc_safety();
         test_auto_gc();
         test_memory_stats();
+        test_gc_tombstone_index();
+        test_incremental_gc();
         
         std::cout << std::endl << "=== ALL TESTS PASSED ===" << std::endl;
         return 0;
@@ -1,8 +1,10 @@
 #include <cassert>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <vector>
 #include "../include/omnisync/core/crdt_atom.hpp"
+#include "../include/omnisync/core/sequence.hpp"
 #include "../include/omnisync/network/binary_packer.hpp"
 #include "../include/omnisync/network/vle_encoding.hpp"
 
@@ -87,6 +89,80 @@ void test_vle_stream_truncated() {
     assert(!result && "Should have rejected truncated stream");
 }
 
+// A v3 snapshot of one client's runs (client index, start clock, length),
+// each parented to the sentinel; client index 0 is the sentinel's client 0
+static std::string snapshotV3(const std::vector<std::vector<uint64_t>>& runs) {
+    std::vector<uint64_t> clients = {0, 7};
+    uint64_t count = 0;
+    for (const auto& run : runs) count += run[2];
+
+    std::vector<uint8_t> body;
+    VLEEncoding::encodeUInt64(count, body);
+    VLEEncoding::encodeUInt64(runs.size(), body);
+    VLEEncoding::encodeUInt64(clients.size(), body);
+    for (uint64_t client : clients) VLEEncoding::encodeUInt64(client, body);
+    for (const auto& run : runs) VLEEncoding::encodeUInt64(run[0], body);
+    uint64_t prev_clock = 0;
+    for (const auto& run : runs) {
+        VLEEncoding::encodeInt64(static_cast<int64_t>(run[1] - prev_clock), body);
+        prev_clock = run[1];
+    }
+    for (const auto& run : runs) VLEEncoding::encodeUInt64(run[2], body);
+    for (size_t r = 0; r < runs.size(); r++) VLEEncoding::encodeUInt64(1, body);
+    for (const auto& run : runs) {
+        VLEEncoding::encodeUInt64(1, body);  // Origin client index 0 + 1
+        VLEEncoding::encodeInt64(static_cast<int64_t>(run[1]), body);
+    }
+    body.insert(body.end(), count, 'x');
+    body.insert(body.end(), (count + 7) / 8, 0);
+    VLEEncoding::encodeUInt64(0, body);  // Empty delete log
+
+    std::string blob = "OMNI";
+    blob.push_back(3);
+    auto put = [&blob](const void* data, size_t size) { blob.append(static_cast<const char*>(data), size); };
+    uint64_t client_id = 9, clock = 0, body_size = body.size();
+    uint32_t vector_entries = 0;
+    put(&client_id, 8);
+    put(&clock, 8);
+    put(&vector_entries, 4);
+    put(&body_size, 8);
+    put(body.data(), body.size());
+    return blob;
+}
+
+// Test 6: v3 snapshots whose runs would corrupt the index
+void test_snapshot_bad_runs() {
+    std::cout << "Test: v3 snapshot with bad runs..." << std::endl;
+
+    auto loads = [](const std::string& blob) {
+        std::istringstream in(blob);
+        Sequence doc(1);
+        bool ok = doc.load(in);
+        assert(ok || doc.length() == 0);
+        return ok;
+    };
+    assert(loads(snapshotV3({{0, 0, 1}, {1, 1, 3}, {1, 10, 2}})) && "Well-formed runs should load");
+    assert(!loads(snapshotV3({{1, 1, 3}})) && "Should have rejected a missing sentinel");
+    assert(!loads(snapshotV3({{1, 1, 3}, {0, 0, 1}})) && "Should have rejected a sentinel that isn't first");
+    assert(!loads(snapshotV3({{0, 0, 1}, {1, 1, 3}, {1, 2, 1}})) && "Should have rejected overlapping runs");
+    assert(!loads(snapshotV3({{0, 0, 1}, {1, 5, 1}, {1, 5, 1}})) && "Should have rejected a repeated run");
+    assert(!loads(snapshotV3({{0, 0, 1}, {0, 0, 1}})) && "Should have rejected a second sentinel");
+}
+
+// Test 7: Delete spans whose clocks run past 64 bits
+void test_delete_span_overflow() {
+    std::cout << "Test: Delete span clock overflow..." << std::endl;
+
+    std::vector<DeleteSpan> spans;
+    auto unpacks = [&spans](DeleteSpan span) {
+        return VLEPacker::unpackDeleteSpans(VLEPacker::packDeleteSpans({span}), spans);
+    };
+    assert(unpacks({7, UINT64_MAX - 4, 1, 5}) && "Last clock UINT64_MAX should fit");
+    assert(!unpacks({7, UINT64_MAX - 4, 1, 6}) && "Should have rejected a span past UINT64_MAX");
+    assert(!unpacks({7, 1, 2, UINT64_MAX / 2 + 2}) && "Should have rejected a stepped span past UINT64_MAX");
+    assert(!unpacks({7, 1, 0, 3}) && "Should have rejected a zero step");
+}
+
 int main() {
     std::cout << "--- Network Malformed Input Tests ---" << std::endl;
     
@@ -96,6 +172,8 @@ int main() {
         test_vle_packer_truncated();
         test_vle_overflow_input();
         test_vle_stream_truncated();
+        test_snapshot_bad_runs();
+        test_delete_span_overflow();
         
         std::cout << "ALL NETWORK MALFORMED TESTS PASSED" << std::endl;
         return 0;
@@ -0,0 +1,236 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include "omnisync/omnisync.hpp"
+
+using namespace omnisync::core;
+
+static void removeFiles(const std::string& base) {
+    std::error_code ec;
+    std::filesystem::remove(base + ".snap", ec);
+    std::filesystem::remove(base + ".snap.tmp", ec);
+    for (int gen = 0; gen < 16; gen++) std::filesystem::remove(base + ".wal." + std::to_string(gen), ec);
+}
+
+static void test_replay_local_and_remote() {
+    const std::string base = "op_log_replay";
+    removeFiles(base);
+
+    Sequence alice(1), bob(2);
+    std::vector<DeleteSpan> spans = {{1, 3, 2, 2}};
+    {
+        OpLog log(base);
+        assert(log.recover(alice));
+        assert(alice.length() == 0);
+
+        alice.localInsertString(0, "hello world");
+        alice.localDelete(0);
+        log.recordLocal(alice);
+        assert(log.commit());
+
+        // Remote inserts, delete ops and legacy span deletes are recorded as applied
+        std::vector<Atom> remote = bob.localInsertString(0, "from bob ");
+        alice.applyDelta(remote);
+        log.recordInserts(remote);
+        bob.applyDelta(alice.getDelta(bob.getVectorClock()));
+        bob.localDeleteRange(0, 5);
+        std::vector<DeleteOp> deletes = bob.getDeleteDelta(alice.getVectorClock());
+        alice.applyDeleteOps(deletes);
+        log.recordDeleteOps(deletes);
+        alice.remoteDeleteRange(spans);
+        log.recordDeleteSpans(spans);
+
+        alice.localDeleteRange(alice.length() - 2, 2);
+        log.recordLocal(alice);
+        assert(log.commit());
+        assert(log.getStats().commits == 2);
+
+        // Uncommitted ops are lost in a crash; this one is committed on close
+        alice.localInsert(alice.length(), '!');
+        log.recordLocal(alice);
+    }
+
+    // A peer that saw everything before the crash
+    Sequence carol(9);
+    carol.applyDelta(alice.getDelta(carol.getVectorClock()));
+    carol.applyDeleteOps(alice.getDeleteDelta(carol.getVectorClock()));
+    carol.remoteDeleteRange(spans);
+    assert(carol.toString() == alice.toString());
+
+    Sequence recovered(1);
+    OpLog log(base);
+    assert(log.recover(recovered));
+    assert(log.getStats().replayed == 7);
+    assert(recovered.toString() == alice.toString());
+    assert(recovered.getTombstoneCount() == alice.getTombstoneCount());
+    for (size_t i = 0; i < alice.length(); i++) assert(recovered.idAt(i) == alice.idAt(i));
+
+    // New ops get clocks past the crash, so the peer's delta picks them up
+    recovered.localDelete(0);
+    recovered.localInsert(recovered.length(), '?');
+    std::vector<Atom> inserts = recovered.getDelta(carol.getVectorClock());
+    std::vector<DeleteOp> fresh = recovered.getDeleteDelta(carol.getVectorClock());
+    assert(inserts.size() == 1 && fresh.size() == 1);
+    carol.applyDelta(inserts);
+    carol.applyDeleteOps(fresh);
+    assert(carol.toString() == recovered.toString());
+
+    removeFiles(base);
+}
+
+static void test_torn_tail() {
+    const std::string base = "op_log_torn";
+    removeFiles(base);
+
+    Sequence doc(3);
+    {
+        OpLog log(base);
+        assert(log.recover(doc));
+        doc.localInsertString(0, "durable");
+        log.recordLocal(doc);
+        assert(log.commit());
+    }
+
+    // A crash mid-write leaves half a frame behind
+    {
+        std::ofstream out(base + ".wal.0", std::ios::binary | std::ios::app);
+        out.write("\x40\x00\x00\x00\x12\x34", 6);
+    }
+
+    Sequence first(3);
+    {
+        OpLog log(base);
+        assert(log.recover(first));
+        assert(first.toString() == "durable");
+        assert(log.getStats().discarded_bytes == 6);
+
+        // Frames appended after the cut are read back
+        first.localInsertString(first.length(), " log");
+        log.recordLocal(first);
+        assert(log.commit());
+    }
+
+    Sequence second(3);
+    OpLog log(base);
+    assert(log.recover(second));
+    assert(second.toString() == "durable log");
+    assert(log.getStats().discarded_bytes == 0);
+
+    removeFiles(base);
+}
+
+static void test_checkpoint() {
+    const std::string base = "op_log_checkpoint";
+    removeFiles(base);
+
+    Sequence doc(4);
+    OpLog::Config config;
+    config.checkpoint_bytes = 4096;
+    {
+        OpLog log(base, config);
+        assert(log.recover(doc));
+        doc.localInsertString(0, std::string(20000, 'a'));
+        log.recordLocal(doc);
+        assert(log.commit());
+        assert(log.checkpointIfNeeded(doc));
+
+        // Edits made while the snapshot is written land in the next log
+        doc.localDeleteRange(100, 50);
+        doc.localInsertString(doc.length(), "tail");
+        log.recordLocal(doc);
+        assert(log.commit());
+        assert(log.waitForCheckpoint());
+        assert(log.getStats().checkpoints == 1);
+        assert(!std::filesystem::exists(log.logPath(0)));
+        assert(std::filesystem::exists(log.logPath(1)));
+        assert(log.logBytes() < 200);
+        assert(!log.checkpointIfNeeded(doc));
+    }
+
+    Sequence recovered(4);
+    OpLog log(base, config);
+    assert(log.recover(recovered));
+    assert(log.getStats().replayed == 2);
+    assert(recovered.toString() == doc.toString());
+    assert(recovered.getTombstoneCount() == doc.getTombstoneCount());
+
+    // A crash after the snapshot is installed but before its logs are
+    // deleted leaves them behind; recovery skips and removes them
+    assert(log.checkpoint(recovered));
+    assert(log.waitForCheckpoint());
+    std::filesystem::copy_file(base + ".wal.2", base + ".wal.1");
+    Sequence again(4);
+    OpLog reopened(base, config);
+    assert(reopened.recover(again));
+    assert(again.toString() == doc.toString());
+    assert(!std::filesystem::exists(base + ".wal.1"));
+
+    removeFiles(base);
+}
+
+static void test_autosave_cost() {
+    const std::string base = "op_log_autosave";
+    removeFiles(base);
+
+    Sequence doc(5);
+    OpLog::Config config;
+    config.sync = false;  // Measure bytes, not the disk
+    OpLog log(base, config);
+    assert(log.recover(doc));
+    doc.localInsertString(0, std::string(1000000, 'x'));
+    log.recordLocal(doc);
+    assert(log.checkpoint(doc));
+    assert(log.waitForCheckpoint());
+
+    std::stringstream full;
+    doc.save(full);
+
+    // 200 autosaves of a few keystrokes each
+    std::mt19937 rng(5);
+    uint64_t before = log.getStats().bytes_written;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int batch = 0; batch < 200; batch++) {
+        size_t at = rng() % doc.length();
+        for (int k = 0; k < 8; k++) doc.localInsert(at + k, static_cast<char>('a' + k));
+        doc.localDelete(rng() % doc.length());
+        log.recordLocal(doc);
+        assert(log.commit());
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double per_batch = double(log.getStats().bytes_written - before) / 200;
+    double us = std::chrono::duration<double, std::micro>(end - start).count() / 200;
+    std::cout << "Autosave: " << per_batch << " bytes and " << us << " us per batch, full save "
+              << full.str().size() << " bytes\n";
+    assert(per_batch * 100 < full.str().size());
+
+    Sequence recovered(5);
+    OpLog reopened(base, config);
+    assert(reopened.recover(recovered));
+    assert(recovered.toString() == doc.toString());
+
+    removeFiles(base);
+}
+
+int main() {
+    std::cout << "--- OmniSync Op Log Test ---\n";
+
+    test_replay_local_and_remote();
+    std::cout << "Replay of local and remote ops: PASS\n";
+
+    test_torn_tail();
+    std::cout << "Torn tail: PASS\n";
+
+    test_checkpoint();
+    std::cout << "Background checkpoint: PASS\n";
+
+    test_autosave_cost();
+    std::cout << "Autosave cost: PASS\n";
+
+    std::cout << "SUCCESS: Op Log Verified.\n";
+    return 0;
+}
@@ -0,0 +1,139 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "omnisync/omnisync.hpp"
+
+using namespace omnisync::core;
+
+static void test_bounded_buffer() {
+    Sequence writer(1);
+    std::string text;
+    for (int i = 0; i < 1000; i++) text += char('a' + i % 26);
+    std::vector<Atom> atoms = writer.localInsertString(0, text);
+
+    // Everything but the first atom arrives, newest first: all orphans
+    Sequence reader(2);
+    reader.setOrphanConfig({100, std::numeric_limits<uint64_t>::max()});
+    for (size_t i = atoms.size() - 1; i >= 1; i--) {
+        reader.remoteMerge(atoms[i]);
+        assert(reader.getOrphanBufferSize() <= 100);
+    }
+    MemoryStats::OrphanStats stats = reader.getMemoryStats().orphan_stats;
+    assert(stats.buffered == 999 && stats.expired == 0);
+    assert(stats.evicted + reader.getOrphanBufferSize() == 999);
+
+    // The orphans that waited longest were dropped; the rest are unblocked
+    size_t kept = reader.getOrphanBufferSize();
+    reader.remoteMerge(atoms[0]);
+    assert(reader.getOrphanBufferSize() == 0);
+    assert(reader.toString() == text.substr(0, kept + 1));
+}
+
+static void test_max_age() {
+    Sequence writer(1), other(3);
+    std::vector<Atom> first = writer.localInsertString(0, "ab");
+    std::vector<Atom> second = other.localInsertString(0, "cd");
+
+    Sequence reader(2);
+    reader.setOrphanConfig({10000, 50});
+    reader.remoteMerge(first[1]);  // Waits for "a"
+    assert(reader.getOrphanBufferSize() == 1);
+
+    // 100 ticks later the next orphan finds it expired
+    for (int i = 0; i < 100; i++) reader.localInsert(reader.length(), 'x');
+    reader.remoteMerge(second[1]);  // Waits for "c"
+    MemoryStats::OrphanStats stats = reader.getMemoryStats().orphan_stats;
+    assert(stats.expired == 1 && stats.evicted == 0);
+    assert(reader.getOrphanBufferSize() == 1);
+
+    // "b" is gone for good; "d" still arrives with its parent
+    reader.remoteMerge(first[0]);
+    reader.remoteMerge(second[0]);
+    std::string result = reader.toString();
+    assert(result.size() == 103 && result.find('b') == std::string::npos && result.find("cd") != std::string::npos);
+    assert(reader.getOrphanBufferSize() == 0);
+
+    // Loading a snapshot empties the buffer
+    reader.remoteMerge(Atom({4, 7}, {4, 6}, 'z'));
+    assert(reader.getOrphanBufferSize() == 1);
+    std::stringstream buffer;
+    writer.save(buffer);
+    assert(reader.load(buffer));
+    assert(reader.getOrphanBufferSize() == 0 && reader.toString() == "ab");
+}
+
+static void test_idle_expiry() {
+    // A deleted orphan that nothing unblocks: local edits alone age it out
+    Sequence reader(2);
+    reader.setOrphanConfig({10000, 50});
+    Atom parent({5, 1}, {0, 0}, 'p');
+    Atom lost({5, 2}, parent.id, 'q');
+    lost.is_deleted = true;
+    reader.applyDelta({lost});
+    assert(reader.getOrphanBufferSize() == 1 && reader.getMemoryStats().delete_buffer_count == 1);
+    for (int i = 0; i < 100; i++) reader.localInsert(reader.length(), 'x');
+    assert(reader.getOrphanBufferSize() == 0 && reader.getMemoryStats().orphan_stats.expired == 1);
+
+    // Its delete is kept: the peer won't send it again, so a retransmitted
+    // insert must still arrive deleted
+    assert(reader.getMemoryStats().delete_buffer_count == 1);
+    lost.is_deleted = false;
+    reader.remoteMerge(parent);
+    reader.remoteMerge(lost);
+    std::string text = reader.toString();
+    assert(text.find('p') != std::string::npos && text.find('q') == std::string::npos);
+    assert(reader.getMemoryStats().delete_buffer_count == 0);
+
+    // Same for orphans evicted from a full buffer
+    Sequence full(3);
+    full.setOrphanConfig({10, std::numeric_limits<uint64_t>::max()});
+    std::vector<Atom> batch;
+    for (uint64_t i = 0; i < 50; i++) {
+        batch.push_back(Atom({6, 2 * i + 2}, {6, 2 * i + 1}, 'y'));
+        batch.back().is_deleted = true;
+    }
+    full.applyDelta(batch);
+    assert(full.getOrphanBufferSize() <= 10);
+    assert(full.getMemoryStats().delete_buffer_count == 50);
+}
+
+static void test_sustained_loss() {
+    // A full buffer under continuous loss: every orphan costs O(log n)
+    const int kOrphans = 200000;
+    Sequence reader(2);
+    reader.setOrphanConfig({10000, std::numeric_limits<uint64_t>::max()});
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint64_t i = 0; i < kOrphans; i++) {
+        reader.remoteMerge(Atom({3, 2 * i + 2}, {3, 2 * i + 1}, 'x'));
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    MemoryStats::OrphanStats stats = reader.getMemoryStats().orphan_stats;
+    assert(reader.getOrphanBufferSize() <= reader.getOrphanConfig().max_orphan_buffer_size);
+    assert(stats.buffered == kOrphans && stats.evicted + reader.getOrphanBufferSize() == kOrphans);
+    std::cout << "  " << kOrphans << " orphans, " << stats.evicted << " evicted, in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+}
+
+int main() {
+    std::cout << "--- OmniSync Orphan Buffer Test ---\n";
+
+    test_bounded_buffer();
+    std::cout << "Bounded buffer: PASS\n";
+
+    test_max_age();
+    std::cout << "Max age: PASS\n";
+
+    test_idle_expiry();
+    std::cout << "Idle expiry: PASS\n";
+
+    test_sustained_loss();
+    std::cout << "Sustained loss: PASS\n";
+
+    std::cout << "SUCCESS: Orphan Buffer Verified.\n";
+    return 0;
+}
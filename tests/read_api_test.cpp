@@ -0,0 +1,230 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "omnisync/omnisync.hpp"
+
+using namespace omnisync::core;
+
+/**
+ * Test 1: indexOf / idAt agree with the materialized text
+ */
+void test_index_queries() {
+    std::cout << "Test 1: indexOf and idAt..." << std::endl;
+
+    Sequence alice(1), bob(2);
+    std::mt19937 rng(3);
+    for (int i = 0; i < 3000; i++) {
+        Sequence& doc = (i % 3 == 0) ? bob : alice;
+        Sequence& peer = (i % 3 == 0) ? alice : bob;
+        std::string text = doc.toString();
+        if (!text.empty() && rng() % 4 == 0) {
+            peer.remoteDelete(doc.localDelete(rng() % text.size()));
+        } else {
+            peer.remoteMerge(doc.localInsert(rng() % (text.size() + 1), static_cast<char>('a' + rng() % 26)));
+        }
+    }
+    alice.localInsertString(alice.length(), std::string(500, '.'));
+
+    std::string text = alice.toString();
+    assert(alice.length() == text.size());
+    for (size_t i = 0; i < text.size(); i++) {
+        OpID id = alice.idAt(i);
+        assert(alice.indexOf(id) == i);
+    }
+
+    for (const Atom& atom : alice.getDelta(VectorClock())) {
+        size_t index = alice.indexOf(atom.id);
+        assert(index <= text.size());
+        if (!atom.is_deleted) assert(text[index] == atom.content);
+    }
+
+    assert(alice.idAt(text.size()) == (OpID{0, 0}));
+    assert(alice.indexOf({42, 42}) == Sequence::npos);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+/**
+ * Test 2: An editor mirror stays in sync from splice events alone
+ */
+void test_splice_events() {
+    std::cout << "Test 2: Remote ops as splice events..." << std::endl;
+
+    Sequence writer(1), reader(2);
+    std::string mirror;
+    std::mt19937 rng(5);
+
+    for (int batch = 0; batch < 50; batch++) {
+        std::vector<Atom> inserts;
+        std::vector<OpID> deletes;
+        for (int i = 0; i < 40; i++) {
+            size_t len = writer.length();
+            if (len > 0 && rng() % 3 == 0) {
+                deletes.push_back(writer.localDelete(rng() % len));
+            } else {
+                inserts.push_back(writer.localInsert(rng() % (len + 1), static_cast<char>('A' + rng() % 26)));
+            }
+        }
+
+        for (const Atom& op : inserts) {
+            reader.remoteMerge(op);
+            mirror.insert(reader.indexOf(op.id), 1, op.content);
+        }
+        for (const OpID& id : deletes) {
+            size_t index = reader.indexOf(id);
+            bool was_visible = reader.idAt(index) == id;
+            reader.remoteDelete(id);
+            if (was_visible) mirror.erase(index, 1);
+        }
+        assert(mirror == reader.toString());
+    }
+
+    std::cout << "  PASS" << std::endl;
+}
+
+/**
+ * Test 3: The cached text view follows every kind of edit
+ */
+void test_text_cache() {
+    std::cout << "Test 3: Materialized text view..." << std::endl;
+
+    Sequence alice(1), bob(2);
+    std::mt19937 rng(9);
+    const std::string& view = bob.text();
+    assert(view.empty());
+
+    for (int round = 0; round < 400; round++) {
+        size_t len = alice.length();
+        int op = rng() % 8;
+        if (op < 4) {
+            bob.remoteMerge(alice.localInsert(rng() % (len + 1), static_cast<char>('a' + rng() % 26)));
+        } else if (op < 6 && len > 0) {
+            bob.remoteDelete(alice.localDelete(rng() % len));
+        } else if (op < 7) {
+            for (const Atom& a : alice.localInsertString(rng() % (len + 1), "pasted text")) bob.remoteMerge(a);
+        } else if (len > 0) {
+            bob.remoteDeleteRange(alice.localDeleteRange(rng() % len, 1 + rng() % 20));
+        }
+
+        // Reads in between keep the cache warm and patched
+        if (round % 3 == 0) assert(bob.text() == alice.toString());
+    }
+    assert(&bob.text() == &view);
+    assert(bob.text() == bob.toString());
+
+    // Dropping tombstones leaves the visible text alone
+    std::string before = bob.text();
+    bob.garbageCollectLocal(0);
+    assert(bob.text() == before);
+    bob.localInsert(bob.length(), '!');
+    assert(bob.text() == before + "!");
+
+    // Unchanged documents hand back the same buffer without rebuilding
+    const char* data = bob.text().data();
+    assert(bob.text().data() == data);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+/**
+ * Test 4: Viewport reads via substring and the visible-character iterator
+ */
+void test_substring_and_iterator() {
+    std::cout << "Test 4: substring and iteration..." << std::endl;
+
+    Sequence doc(1);
+    std::string model;
+    for (int i = 0; i < 40000; i++) model += static_cast<char>('a' + (i * 7) % 26);
+    doc.localInsertString(0, model);
+
+    // Punch holes: single tombstones and whole deleted chunks
+    std::mt19937 rng(13);
+    for (int i = 0; i < 200; i++) {
+        size_t index = rng() % model.size();
+        doc.localDelete(index);
+        model.erase(index, 1);
+    }
+    doc.localDeleteRange(10000, 5000);
+    model.erase(10000, 5000);
+    assert(doc.text() == model);
+
+    assert(std::string(doc.begin(), doc.end()) == model);
+    size_t index = 0;
+    for (auto it = doc.begin(); it != doc.end(); ++it, index++) {
+        if (index % 997 == 0) assert(it.id() == doc.idAt(index));
+    }
+    assert(index == model.size());
+
+    for (int i = 0; i < 500; i++) {
+        size_t pos = rng() % (model.size() + 10);
+        size_t len = rng() % 5000;
+        std::string expected = pos < model.size() ? model.substr(pos, len) : "";
+        assert(doc.substring(pos, len) == expected);
+    }
+    assert(doc.substring(model.size() - 1, 100) == model.substr(model.size() - 1));
+    assert(doc.iteratorAt(model.size()) == doc.end());
+    assert(*doc.iteratorAt(9999) == model[9999] && *doc.iteratorAt(10000) == model[10000]);
+
+    Sequence empty(2);
+    assert(empty.begin() == empty.end());
+    assert(empty.substring(0, 10).empty());
+
+    // A 4 KB viewport of a multi-MB document
+    Sequence big(3);
+    big.localInsertString(0, std::string(4 << 20, 'x'));
+    auto start = std::chrono::high_resolution_clock::now();
+    std::string view = big.substring(2 << 20, 4096);
+    auto end = std::chrono::high_resolution_clock::now();
+    double us = std::chrono::duration<double, std::micro>(end - start).count();
+    std::cout << "  4 KB viewport of 4 MB document in " << us << " us" << std::endl;
+    assert(view == std::string(4096, 'x'));
+
+    std::cout << "  PASS" << std::endl;
+}
+
+/**
+ * Test 5: Threads reading one document while nobody edits it
+ */
+void test_concurrent_reads() {
+    std::cout << "Test 5: Concurrent const reads..." << std::endl;
+
+    Sequence doc(1);
+    std::vector<Atom> ops = doc.localInsertString(0, std::string(2000, 'r'));
+    doc.localDeleteRange(100, 50);
+    doc.localInsertString(500, "patched");
+    std::string expected = doc.toString() + "!";
+    doc.localInsert(doc.length(), '!');  // Queues a patch the first concurrent read applies
+
+    // First reads race to apply the pending patch and move the locate() hint
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([&, t] {
+            for (int i = 0; i < 200; i++) {
+                assert(doc.toString() == expected);
+                size_t k = (t * 997 + i * 131) % ops.size();
+                if (k >= 100 && k < 150) continue;  // Deleted above
+                assert(doc.idAt(doc.indexOf(ops[k].id)) == ops[k].id);
+            }
+        });
+    }
+    for (auto& t : readers) t.join();
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== OmniSync Read API Tests ===" << std::endl << std::endl;
+
+    test_index_queries();
+    test_splice_events();
+    test_text_cache();
+    test_substring_and_iterator();
+    test_concurrent_reads();
+
+    std::cout << std::endl << "=== ALL TESTS PASSED ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,353 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <string>
+#include "omnisync/omnisync.hpp"
+
+using namespace omnisync::core;
+
+static size_t g_slab_allocations = 0;
+static size_t g_slab_deallocations = 0;
+
+/**
+ * Minimal allocator that counts slab requests made by the document pools.
+ */
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        g_slab_allocations++;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) {
+        g_slab_deallocations++;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>&) const { return false; }
+};
+
+/**
+ * Test 1: Documents spanning many chunks keep content and positions intact
+ */
+void test_multi_chunk_edits() {
+    std::cout << "Test 1: Multi-chunk edits..." << std::endl;
+
+    Sequence doc(1);
+    std::string model;
+    std::mt19937 rng(7);
+
+    // Appends fill several chunks
+    for (int i = 0; i < 5000; i++) {
+        char c = static_cast<char>('a' + (i % 26));
+        doc.localInsert(model.size(), c);
+        model += c;
+    }
+    assert(doc.toString() == model);
+
+    // Random deletes hit every chunk
+    for (int i = 0; i < 2000; i++) {
+        std::uniform_int_distribution<size_t> dist(0, model.size() - 1);
+        size_t index = dist(rng);
+        doc.localDelete(index);
+        model.erase(index, 1);
+    }
+    assert(doc.toString() == model);
+    assert(doc.getTombstoneCount() == 2000);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+/**
+ * Test 2: GC shrinks chunks and merges sparse neighbors without losing order
+ */
+void test_gc_merges_chunks() {
+    std::cout << "Test 2: GC merges sparse chunks..." << std::endl;
+
+    Sequence doc(1);
+    std::string model;
+    for (int i = 0; i < 3000; i++) {
+        char c = static_cast<char>('A' + (i % 26));
+        doc.localInsert(model.size(), c);
+        model += c;
+    }
+
+    // Delete 90% of the document, leaving chunks almost empty
+    size_t index = 0;
+    for (size_t visited = 0; index < model.size(); visited++) {
+        if (visited % 10 == 0) {
+            index++;
+        } else {
+            doc.localDelete(index);
+            model.erase(index, 1);
+        }
+    }
+    assert(doc.toString() == model);
+
+    size_t bytes_before = doc.getMemoryStats().atom_list_bytes;
+    size_t removed = doc.garbageCollectLocal(0);
+    size_t bytes_after = doc.getMemoryStats().atom_list_bytes;
+
+    std::cout << "  Removed " << removed << " tombstones, storage "
+              << bytes_before / 1024 << " KB -> " << bytes_after / 1024 << " KB" << std::endl;
+    assert(removed > 0);
+    assert(bytes_after < bytes_before);
+    assert(doc.toString() == model);
+
+    // The index must still resolve positions after merges
+    doc.localInsert(model.size(), '!');
+    model += '!';
+    doc.localDelete(0);
+    model.erase(0, 1);
+    assert(doc.toString() == model);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+/**
+ * Test 3: Remote replicas converge when edits split chunks in the middle
+ */
+void test_remote_splits() {
+    std::cout << "Test 3: Remote merges split chunks..." << std::endl;
+
+    Sequence alice(1), bob(2);
+    std::vector<Atom> ops;
+    for (int i = 0; i < 500; i++) {
+        ops.push_back(alice.localInsert(i, 'x'));
+    }
+    for (const auto& op : ops) bob.remoteMerge(op);
+
+    // Concurrent edits anchored in the middle of full chunks
+    std::vector<Atom> from_alice, from_bob;
+    for (int i = 0; i < 200; i++) {
+        from_alice.push_back(alice.localInsert(37 + i * 2, 'a'));
+        from_bob.push_back(bob.localInsert(101 + i, 'b'));
+    }
+    for (const auto& op : from_alice) bob.remoteMerge(op);
+    for (const auto& op : from_bob) alice.remoteMerge(op);
+    assert(alice.toString() == bob.toString());
+
+    // Round-trip through persistence
+    std::stringstream buffer;
+    alice.save(buffer);
+    Sequence restored(3);
+    assert(restored.load(buffer));
+    assert(restored.toString() == alice.toString());
+
+    std::cout << "  PASS" << std::endl;
+}
+
+/**
+ * Test 4: Chunks and index nodes come from per-document slabs
+ */
+void test_pooled_allocator() {
+    std::cout << "Test 4: Pooled storage with custom allocator..." << std::endl;
+
+    std::stringstream buffer;
+    {
+        BasicSequence<char, CountingAllocator<char>> doc(1);
+        for (int i = 0; i < 20000; i++) {
+            doc.localInsert(i, 'p');
+        }
+        for (int i = 0; i < 5000; i++) {
+            doc.localDelete(i);
+        }
+        doc.garbageCollectLocal(0);
+
+        std::cout << "  Slab allocations for 20000 atoms: " << g_slab_allocations << std::endl;
+        assert(g_slab_allocations > 0);
+        assert(g_slab_allocations < 40);
+        assert(doc.toString().size() == 15000);
+
+        doc.save(buffer);
+
+        // Reloading releases the old slabs in bulk before rebuilding
+        size_t released_before = g_slab_deallocations;
+        assert(doc.load(buffer));
+        assert(g_slab_deallocations > released_before);
+        assert(doc.toString().size() == 15000);
+    }
+    assert(g_slab_allocations == g_slab_deallocations);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+/**
+ * Test 5: Sequential typing collapses into a few id/origin runs
+ */
+void test_run_compression() {
+    std::cout << "Test 5: Run-length encoded atoms..." << std::endl;
+
+    Sequence alice(1), bob(2);
+    std::vector<Atom> typed;
+    for (int i = 0; i < 10000; i++) {
+        typed.push_back(alice.localInsert(i, static_cast<char>('a' + (i % 26))));
+    }
+    for (const auto& op : typed) bob.remoteMerge(op);
+
+    MemoryStats stats = alice.getMemoryStats();
+    std::cout << "  10000 typed atoms stored as " << stats.run_count << " runs" << std::endl;
+    assert(stats.run_count < 200);
+    assert(bob.getMemoryStats().run_count == stats.run_count);
+
+    // Deletes only flip tombstone bits; runs stay intact
+    for (int i = 0; i < 100; i++) alice.localDelete(i * 50);
+    assert(alice.getMemoryStats().run_count == stats.run_count);
+
+    // Concurrent inserts inside a run split it, then everything converges
+    Atom a = alice.localInsert(5000, 'X');
+    Atom b = bob.localInsert(2500, 'Y');
+    alice.remoteMerge(b);
+    bob.remoteMerge(a);
+    for (auto& op : alice.getDelta(VectorClock())) {
+        if (op.is_deleted) bob.remoteDelete(op.id);
+    }
+    assert(alice.toString() == bob.toString());
+    assert(alice.getMemoryStats().run_count > stats.run_count);
+
+    // GC of tombstones inside runs keeps every remaining id resolvable
+    alice.garbageCollectLocal(0);
+    Atom c = alice.localInsert(1234, 'Z');
+    bob.remoteMerge(c);
+    bob.garbageCollectLocal(0);
+    assert(alice.toString() == bob.toString());
+
+    std::cout << "  PASS" << std::endl;
+}
+
+/**
+ * Test 6: Many users inserting at the same spot converge quickly
+ */
+void test_concurrent_siblings() {
+    std::cout << "Test 6: 50 users pasting at one position..." << std::endl;
+
+    const int users = 50;
+    Sequence origin_doc(100);
+    std::vector<Atom> base = origin_doc.localInsertString(0, "Agenda:\n");
+
+    // Everyone pastes several items after "Agenda:" before hearing from anyone
+    std::vector<std::vector<Atom>> ops(users);
+    for (int u = 0; u < users; u++) {
+        Sequence doc(u + 1);
+        for (const Atom& op : base) doc.remoteMerge(op);
+        for (int item = 0; item < 10; item++) {
+            std::string text = "- item " + std::to_string(u) + "." + std::to_string(item) + "\n";
+            for (const Atom& op : doc.localInsertString(8, text)) ops[u].push_back(op);
+        }
+    }
+
+    // One replica hears user by user, the other round-robin from the back
+    Sequence forward(200), interleaved(201);
+    for (const Atom& op : base) {
+        forward.remoteMerge(op);
+        interleaved.remoteMerge(op);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int u = 0; u < users; u++) {
+        for (const Atom& op : ops[u]) forward.remoteMerge(op);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+    size_t longest = 0;
+    for (const auto& list : ops) longest = std::max(longest, list.size());
+    for (size_t i = 0; i < longest; i++) {
+        for (int u = users - 1; u >= 0; u--) {
+            if (i < ops[u].size()) interleaved.remoteMerge(ops[u][i]);
+        }
+    }
+
+    std::cout << "  Merged " << forward.length() << " chars in " << ms << " ms" << std::endl;
+    assert(forward.toString() == interleaved.toString());
+    assert(forward.toString().rfind("Agenda:\n", 0) == 0);
+
+    // Each pasted item stays contiguous
+    std::string text = forward.toString();
+    for (int u = 0; u < users; u += 7) {
+        assert(text.find("- item " + std::to_string(u) + ".9\n") != std::string::npos);
+    }
+
+    std::cout << "  PASS" << std::endl;
+}
+
+/**
+ * Test 7: A peer's id landing inside another of its step-2 runs
+ */
+void test_interleaved_client_ids() {
+    std::cout << "Test 7: Interleaved ids from one client..." << std::endl;
+
+    // {90,10} -> {90,12} -> {90,14} forms one step-2 run; {90,11} arrives
+    // later, in another chunk or right after the run
+    for (int placement = 0; placement < 2; placement++) {
+        Sequence doc(1);
+        std::vector<Atom> filler = doc.localInsertString(0, std::string(300, 'x'));
+        Atom a({90, 10}, filler.back().id, 'a');
+        Atom b({90, 12}, a.id, 'b');
+        Atom c({90, 14}, b.id, 'c');
+        Atom y({90, 11}, placement == 0 ? filler[10].id : c.id, 'y');
+        for (const Atom& atom : {a, b, c, y}) doc.remoteMerge(atom);
+        doc.indexOf(filler[150].id);  // Moves the lookup cache away
+
+        std::string expected = std::string(300, 'x') + "abc";
+        expected.insert(placement == 0 ? 11 : expected.size(), "y");
+        assert(doc.toString() == expected);
+        for (const Atom& atom : {a, b, c, y}) assert(doc.idAt(doc.indexOf(atom.id)) == atom.id);
+
+        doc.remoteDelete(b.id);
+        expected.erase(expected.find('b'), 1);
+        assert(doc.toString() == expected);
+        assert(doc.getMemoryStats().delete_buffer_count == 0);
+
+        // Snapshots keep the runs apart and reload them the same way
+        for (int version : {2, 3}) {
+            std::stringstream saved;
+            doc.save(saved, version);
+            Sequence loaded(2);
+            assert(loaded.load(saved));
+            assert(loaded.toString() == expected);
+            for (const Atom& atom : {a, c, y}) assert(loaded.idAt(loaded.indexOf(atom.id)) == atom.id);
+            loaded.remoteDelete(b.id);  // Found as a tombstone, not buffered
+            assert(loaded.getMemoryStats().delete_buffer_count == 0);
+        }
+    }
+
+    // The same ids arriving with the gap already filled never join
+    Sequence doc(1);
+    Atom y({90, 11}, {0, 0}, 'y');
+    Atom a({90, 10}, {0, 0}, 'a');
+    Atom b({90, 12}, a.id, 'b');
+    for (const Atom& atom : {y, a, b}) doc.remoteMerge(atom);
+    doc.remoteDelete(b.id);
+    assert(doc.toString() == "ya" || doc.toString() == "ay");
+    assert(doc.getMemoryStats().delete_buffer_count == 0);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== OmniSync Rope Storage Tests ===" << std::endl << std::endl;
+
+    test_multi_chunk_edits();
+    test_gc_merges_chunks();
+    test_remote_splits();
+    test_pooled_allocator();
+    test_run_compression();
+    test_concurrent_siblings();
+    test_interleaved_client_ids();
+
+    std::cout << std::endl << "=== ALL TESTS PASSED ===" << std::endl;
+    return 0;
+}
@@ -1,6 +1,10 @@
 #include <iostream>
 #include <fstream>
 #include <cassert>
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <string>
 #include <vector>
 #include "omnisync/omnisync.hpp"
 
@@ -36,6 +40,122 @@ static void test_unsupported_version() {
     assert(!ok && "load should fail for unsupported save format version");
 }
 
+static void test_truncated_atoms() {
+    Sequence doc(11);
+    doc.localInsertString(0, "truncated snapshot");
+    std::stringstream full;
+    doc.save(full, 2);
+    std::string data = full.str();
+
+    std::stringstream cut(data.substr(0, data.size() - 10));
+    Sequence loaded(12);
+    bool ok = loaded.load(cut);
+    assert(!ok && "load should fail when atom records are cut short");
+    // The whole records before the cut are kept, in a usable document
+    loaded.localInsert(loaded.length(), 'x');
+    assert(loaded.toString() == "truncated snapshox");
+}
+
+static void test_large_roundtrip() {
+    Sequence alice(1), bob(2);
+    bob.applyDelta(alice.localInsertString(0, std::string(400000, 'a')));
+    std::mt19937 rng(21);
+    for (int i = 0; i < 2000; i++) {
+        size_t len = alice.length();
+        if (i % 3 == 0) bob.remoteDelete(alice.localDelete(rng() % len));
+        else bob.remoteMerge(alice.localInsert(rng() % len, static_cast<char>('b' + i % 20)));
+    }
+    bob.remoteDeleteRange(alice.localDeleteRange(100000, 50000));
+
+    std::stringstream buffer;
+    alice.save(buffer);
+    Sequence loaded(3);
+    auto start = std::chrono::high_resolution_clock::now();
+    assert(loaded.load(buffer));
+    auto end = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    std::cout << "Loaded " << alice.getMemoryStats().atom_count << " atoms in " << ms << " ms\n";
+
+    // Positions, ids and tombstones all come back
+    std::string text = alice.toString();
+    assert(loaded.toString() == text);
+    assert(loaded.length() == text.size());
+    assert(loaded.getTombstoneCount() == alice.getTombstoneCount());
+    for (int i = 0; i < 1000; i++) {
+        size_t index = rng() % text.size();
+        assert(loaded.idAt(index) == alice.idAt(index));
+        assert(loaded.indexOf(alice.idAt(index)) == index);
+    }
+
+    // The rebuilt index keeps working under edits and GC
+    for (int i = 0; i < 2000; i++) {
+        Atom op = loaded.localInsert(rng() % (loaded.length() + 1), 'z');
+        bob.remoteMerge(op);
+        alice.remoteMerge(op);
+    }
+    assert(loaded.toString() == alice.toString());
+    assert(loaded.garbageCollectLocal(0) == alice.garbageCollectLocal(0));
+    assert(loaded.toString() == alice.toString());
+}
+
+static void test_columnar_format() {
+    Sequence alice(1), bob(2);
+    bob.applyDelta(alice.localInsertString(0, std::string(100000, 'a')));
+    for (int i = 0; i < 200; i++) {
+        bob.applyDelta(alice.localInsertString(alice.length(), "typed by bob "));
+        bob.localInsertString(bob.length(), "and alice ");
+        alice.applyDelta(bob.getDelta(alice.getVectorClock()));
+    }
+    alice.localDeleteRange(1000, 20000);
+    for (int i = 0; i < 50; i++) alice.localDelete(i * 100);
+
+    std::stringstream compact, fixed;
+    alice.save(compact);
+    alice.save(fixed, 2);
+    size_t atoms = alice.getMemoryStats().atom_count;
+    std::cout << "v3: " << compact.str().size() << " bytes, v2: " << fixed.str().size()
+              << " bytes for " << atoms << " atoms\n";
+    assert(compact.str().size() * 10 < fixed.str().size());
+
+    // Same document out of both formats
+    Sequence from_v3(3), from_v2(4);
+    assert(from_v3.load(compact));
+    assert(from_v2.load(fixed));
+    std::string text = alice.toString();
+    assert(from_v3.toString() == text && from_v2.toString() == text);
+    assert(from_v3.getTombstoneCount() == alice.getTombstoneCount());
+    for (size_t i = 0; i < text.size(); i += 997) {
+        assert(from_v3.idAt(i) == alice.idAt(i));
+        assert(from_v3.indexOf(alice.idAt(i)) == i);
+    }
+
+    // The delete log survives v3, so the loaded copy can still relay deletes
+    std::vector<DeleteOp> deletes = from_v3.getDeleteDelta(bob.getVectorClock());
+    assert(deletes.size() == alice.getDeleteDelta(bob.getVectorClock()).size());
+    bob.applyDeleteOps(deletes);
+    assert(bob.toString() == text);
+    assert(from_v2.getDeleteDelta(bob.getVectorClock()).empty());
+
+    // Cut or damaged bodies are rejected and leave an empty, usable document
+    std::string data = compact.str();
+    std::stringstream cut(data.substr(0, data.size() - 3));
+    Sequence truncated(5);
+    assert(!truncated.load(cut));
+    truncated.localInsert(0, 'x');
+    assert(truncated.toString() == "x");
+
+    // Both formats share the header; v3 then has an 8-byte body size
+    size_t body_at = fixed.str().size() - 8 - 34 * atoms + 8;
+    for (size_t at : {body_at, body_at + 1, body_at + 2}) {
+        std::string bad = data;
+        bad[at] = static_cast<char>(0xff);
+        std::stringstream in(bad);
+        Sequence damaged(6);
+        assert(!damaged.load(in));
+        assert(damaged.length() == 0);
+    }
+}
+
 int main() {
     std::cout << "--- OmniSync Persistence Test ---\n";
 
@@ -92,8 +212,17 @@ int main() {
     // 6. Negative tests for malformed persistence input
     test_invalid_magic();
     test_unsupported_version();
+    test_truncated_atoms();
     std::cout << "Malformed-input checks: PASS\n";
 
+    // 7. Large documents round-trip through the bulk index build
+    test_large_roundtrip();
+    std::cout << "Large round trip: PASS\n";
+
+    // 8. Columnar format is compact and round-trips the delete log
+    test_columnar_format();
+    std::cout << "Columnar format: PASS\n";
+
     std::cout << "SUCCESS: Save/Load Verified.\n";
     return 0;
 }
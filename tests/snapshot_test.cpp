@@ -0,0 +1,202 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include "omnisync/omnisync.hpp"
+
+using namespace omnisync::core;
+
+static std::string snapshotBytes(const Sequence& doc) {
+    std::stringstream out;
+    doc.saveSnapshot(out);
+    return out.str();
+}
+
+/**
+ * Test 1: The view answers reads exactly like the live document
+ */
+void test_view_matches_document() {
+    std::cout << "Test 1: SnapshotView reads..." << std::endl;
+
+    Sequence alice(1), bob(2);
+    std::mt19937 rng(17);
+    bob.applyDelta(alice.localInsertString(0, std::string(3000, 'a')));
+    for (int i = 0; i < 3000; i++) {
+        Sequence& doc = (i % 4 == 0) ? bob : alice;
+        Sequence& peer = (i % 4 == 0) ? alice : bob;
+        size_t len = doc.length();
+        if (rng() % 3 == 0) peer.remoteDelete(doc.localDelete(rng() % len));
+        else peer.remoteMerge(doc.localInsert(rng() % (len + 1), static_cast<char>('b' + rng() % 24)));
+    }
+    alice.localDeleteRange(100, 700);
+
+    std::string bytes = snapshotBytes(alice);
+    SnapshotView view;
+    assert(view.open(bytes.data(), bytes.size()));
+    assert(view.clientId() == 1);
+    assert(view.length() == alice.length());
+    assert(view.text() == alice.text());
+    assert(view.toString() == alice.toString());
+    assert(view.vectorClock().get(2) == alice.getVectorClock().get(2));
+
+    for (int i = 0; i < 2000; i++) {
+        size_t index = rng() % (alice.length() + 5);
+        assert(view.idAt(index) == alice.idAt(index));
+        size_t len = rng() % 300;
+        assert(view.substring(index, len) == alice.substring(index, len));
+    }
+
+    // Promotion rebuilds the same document
+    Sequence promoted(99);
+    assert(promoted.load(view));
+    assert(promoted.toString() == alice.toString());
+    assert(promoted.getTombstoneCount() == alice.getTombstoneCount());
+    assert(promoted.getDelta(VectorClock()).size() == alice.getDelta(VectorClock()).size());
+    Atom op = promoted.localInsert(promoted.length(), '!');
+    alice.remoteMerge(op);
+    assert(promoted.toString() == alice.toString());
+
+    std::cout << "  PASS" << std::endl;
+}
+
+/**
+ * Test 2: Malformed snapshots are rejected without reading past the end
+ */
+void test_malformed_snapshots() {
+    std::cout << "Test 2: Malformed snapshots..." << std::endl;
+
+    Sequence doc(1);
+    doc.localInsertString(0, "mapped snapshot");
+    doc.localDelete(3);
+    std::string bytes = snapshotBytes(doc);
+
+    SnapshotView view;
+    assert(view.open(bytes.data(), bytes.size()));
+    assert(!view.open(bytes.data(), bytes.size() - 8));
+    assert(!view.valid() && view.length() == 0);
+    assert(!view.open(bytes.data(), 10));
+
+    std::string bad_magic = bytes;
+    bad_magic[0] = 'X';
+    assert(!view.open(bad_magic.data(), bad_magic.size()));
+
+    // Huge counts in the header must not overflow the size check
+    std::string bad_count = bytes;
+    for (int i = 24; i < 32; i++) bad_count[i] = static_cast<char>(0xFF);
+    assert(!view.open(bad_count.data(), bad_count.size()));
+
+    // Weights that disagree with the deleted bitmap
+    assert(view.open(bytes.data(), bytes.size()) && view.deleteOpCount() == 1);
+    SnapshotLayout layout(view.atomCount(), 1, view.deleteOpCount());
+    std::string bad_weight = bytes;
+    bad_weight[layout.delete_count - 8] ^= 1;
+    assert(!view.open(bad_weight.data(), bad_weight.size()));
+
+    // Delete-op counts past the end and empty delete ops
+    std::string bad_deletes = bytes;
+    bad_deletes[layout.delete_count] = 2;
+    assert(!view.open(bad_deletes.data(), bad_deletes.size()));
+    std::string empty_delete = bytes;
+    for (size_t i = layout.delete_ops + 40; i < layout.delete_ops + 48; i++) empty_delete[i] = 0;
+    assert(!view.open(empty_delete.data(), empty_delete.size()));
+
+    // Version 1 files end after the weights and have no delete log
+    std::string v1 = bytes.substr(0, layout.delete_count);
+    v1[4] = 1;
+    assert(view.open(v1.data(), v1.size()) && view.deleteOpCount() == 0);
+    assert(view.toString() == doc.toString());
+
+    Sequence target(2);
+    assert(!target.load(SnapshotView()));
+
+    std::cout << "  PASS" << std::endl;
+}
+
+/**
+ * Test 3: A mapped document serves reads and promotes on first edit
+ */
+void test_mapped_document() {
+    std::cout << "Test 3: MappedDocument..." << std::endl;
+
+    Sequence doc(7);
+    std::string model;
+    for (int i = 0; i < 1000000; i++) model += static_cast<char>('a' + i % 26);
+    doc.localInsertString(0, model);
+    doc.localDeleteRange(500000, 1000);
+    model.erase(500000, 1000);
+    {
+        std::ofstream out("snapshot_test.omnm", std::ios::binary);
+        doc.saveSnapshot(out);
+    }
+
+    MappedDocument mapped;
+    assert(!mapped.open("missing_snapshot.omnm"));
+    auto start = std::chrono::high_resolution_clock::now();
+    assert(mapped.open("snapshot_test.omnm"));
+    std::string viewport = mapped.substring(600000, 4096);
+    auto end = std::chrono::high_resolution_clock::now();
+    double us = std::chrono::duration<double, std::micro>(end - start).count();
+    std::cout << "  Opened 1M-atom snapshot and read 4 KB in " << us << " us" << std::endl;
+
+    assert(!mapped.isPromoted());
+    assert(viewport == model.substr(600000, 4096));
+    assert(mapped.length() == model.size());
+    assert(mapped.idAt(12345) == doc.idAt(12345));
+
+    mapped.edit().localInsert(mapped.length(), '!');
+    assert(mapped.isPromoted());
+    assert(mapped.toString() == model + "!");
+    assert(mapped.edit().getVectorClock().get(7) > doc.getVectorClock().get(7));
+
+    std::remove("snapshot_test.omnm");
+    std::cout << "  PASS" << std::endl;
+}
+
+/**
+ * Test 4: A document promoted from a snapshot relays deletes its peers haven't seen
+ */
+void test_snapshot_keeps_delete_log() {
+    std::cout << "Test 4: Delete log in snapshots..." << std::endl;
+
+    Sequence author(1), peer(2);
+    peer.applyDelta(author.localInsertString(0, "the quick brown fox"));
+    author.localDeleteRange(4, 6);
+    author.localDelete(0);
+    {
+        std::ofstream out("snapshot_deletes.omnm", std::ios::binary);
+        author.saveSnapshot(out);
+    }
+
+    MappedDocument mapped;
+    assert(mapped.open("snapshot_deletes.omnm"));
+    Sequence& relay = mapped.edit();
+    std::vector<DeleteOp> deletes = relay.getDeleteDelta(peer.getVectorClock());
+    assert(deletes.size() == author.getDeleteDelta(peer.getVectorClock()).size() && !deletes.empty());
+    peer.applyDeleteOps(deletes);
+    assert(peer.toString() == author.toString());
+    assert(peer.toString() == "he brown fox");
+
+    // Deletes made after promotion still join the restored log
+    relay.localDelete(0);
+    peer.applyDeleteOps(relay.getDeleteDelta(peer.getVectorClock()));
+    assert(peer.toString() == "e brown fox");
+
+    std::remove("snapshot_deletes.omnm");
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== OmniSync Mapped Snapshot Tests ===" << std::endl << std::endl;
+
+    test_view_matches_document();
+    test_malformed_snapshots();
+    test_mapped_document();
+    test_snapshot_keeps_delete_log();
+
+    std::cout << std::endl << "=== ALL TESTS PASSED ===" << std::endl;
+    return 0;
+}